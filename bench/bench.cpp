@@ -0,0 +1,239 @@
+/**
+ * Author:          Cynthia Wang
+ * Date created:    10/19/2026
+ * Organization:    ECE 4122
+ *
+ * Description:
+ * Microbenchmarks of libtabuwave on a VCD file: tokenizing, parsing and
+ * storing values, getValueAt, table frame formatting and queries. Results
+ * are printed as JSON to stdout.
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "Batch.hpp"
+#include "FrameCache.hpp"
+#include "WaveformFile.hpp"
+
+/**
+ * @brief Result of one benchmark.
+ */
+struct Result
+{
+    std::string name;
+    uint64_t ops;     // operations done
+    double seconds;   // wall time of all of them
+    double rate;      // work per second in `unit`
+    std::string unit;
+};
+
+/**
+ * @brief helper function to time a benchmark
+ *
+ * @param fn (const std::function<void()>&) work to time
+ * @return double seconds elapsed
+ */
+double time_of(const std::function<void()>& fn)
+{
+    auto start = std::chrono::steady_clock::now();
+    fn();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+/**
+ * @brief helper function to escape a string for JSON
+ */
+std::string json_string(const std::string& str)
+{
+    std::string escaped = "\"";
+    for (char c : str)
+    {
+        if (c == '"' || c == '\\') escaped += '\\';
+        escaped += c;
+    }
+    return escaped + "\"";
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        std::cerr << "bench <file.vcd> [iterations]\n";
+        return 1;
+    }
+    std::string path = argv[1];
+    uint64_t iterations = (argc > 2) ? std::stoull(argv[2]) : 200000;
+    std::vector<Result> results;
+    std::mt19937_64 rng(1);
+
+    // tokenizing, the way Parser::parseFile reads a line at a time and
+    // splits it with a stringstream
+    uint64_t bytes = 0, tokens = 0;
+    double seconds = time_of(
+        [&]()
+        {
+            std::ifstream file(path);
+            std::string line, token;
+            while (std::getline(file, line))
+            {
+                bytes += line.size() + 1;
+                std::stringstream ss(line);
+                while (ss >> token)
+                {
+                    tokens++;
+                }
+            }
+        }
+    );
+    if (!bytes)
+    {
+        std::cerr << "Could not read " << path << "\n";
+        return 1;
+    }
+    results.push_back(Result{"tokenize", tokens, seconds, bytes / seconds / 1e6, "MB/s"});
+    std::cerr << "tokenize: " << results.back().rate << " MB/s\n";
+
+    // parsing and storing the values
+    WaveformFile waveform;
+    bool opened = false;
+    seconds = time_of([&]() { opened = waveform.open(path); });
+    if (!opened)
+    {
+        std::cerr << waveform.getError() << "\n";
+        return 1;
+    }
+    results.push_back(Result{"parse", 1, seconds, bytes / seconds / 1e6, "MB/s"});
+    std::cerr << "parse: " << results.back().rate << " MB/s\n";
+
+    SignalIndex& index = waveform.getWaveform()->getIndex();
+    std::vector<VcdPrimitive*> primitives;
+    std::vector<std::string> names;
+    for (SignalIndex::Id id = 0; id < index.size(); id++)
+    {
+        VcdPrimitive* primitive = dynamic_cast<VcdPrimitive*>(index.getNode(id));
+        // elements are benchmarked through their arrays
+        if (!primitive || (index.getParent(id) != SignalIndex::NONE
+            && index.getNode(index.getParent(id))->getType() == VcdNode::ARR_SCOPE)) continue;
+        primitives.push_back(primitive);
+        names.push_back(index.getPath(id));
+    }
+    if (primitives.empty())
+    {
+        std::cerr << "No signals in " << path << "\n";
+        return 1;
+    }
+    uint64_t endTime = waveform.getEndTime();
+
+    // getValueAt of random signals at random times
+    uint64_t checksum = 0;
+    seconds = time_of(
+        [&]()
+        {
+            for (uint64_t i = 0; i < iterations; i++)
+            {
+                VcdPrimitive* primitive = primitives[rng() % primitives.size()];
+                checksum += primitive->getValueAt(rng() % (endTime + 1), primitive->getSize()).size();
+            }
+        }
+    );
+    results.push_back(Result{"getValueAt", iterations, seconds, iterations / seconds, "ops/s"});
+    std::cerr << "getValueAt: " << results.back().rate << " ops/s\n";
+
+    // frames of a 40 row table of 8 columns, stepping through time like
+    // holding the right arrow, decoded and formatted like printTable
+    FrameCache::Columns columns;
+    std::vector<size_t> widths;
+    for (size_t i = 0; i < std::min((size_t)8, primitives.size()); i++)
+    {
+        size_t c = (i * primitives.size()) / 8;
+        columns.emplace_back(names[c], primitives[c]);
+        widths.push_back(std::max(primitives[c]->getWidth(), names[c].size()));
+    }
+    uint64_t frames = std::min(iterations / 10, endTime + 1);
+    uint64_t characters = 0;
+    seconds = time_of(
+        [&]()
+        {
+            FrameCache cache(128, 0);
+            cache.setWindow(columns, 0, 40);
+            std::ostringstream row;
+            for (uint64_t time = 0; time < frames; time++)
+            {
+                std::shared_ptr<const FrameCache::Frame> frame = cache.get(time);
+                for (size_t r = 0; r < 40; r++)
+                {
+                    row.str("");
+                    row << std::setw(6) << r << " |";
+                    for (size_t c = 0; c < columns.size(); c++)
+                    {
+                        const std::vector<std::string>& values = frame->at(columns[c].first);
+                        row << ' ' << std::setw(widths[c]) << ((r < values.size()) ? values[r] : "") << " |";
+                    }
+                    characters += row.str().size();
+                }
+            }
+        }
+    );
+    results.push_back(Result{"frame", frames, seconds, frames / seconds, "frames/s"});
+    std::cerr << "frame: " << results.back().rate << " frames/s\n";
+
+    // batch queries over the whole run with a condition, like ? in the table
+    std::ostringstream queries;
+    size_t numQueries = std::min((size_t)16, primitives.size());
+    for (size_t i = 0; i < numQueries; i++)
+    {
+        const std::string& name = names[(i * primitives.size()) / numQueries];
+        queries << name << " from 0 to " << endTime << " every " << std::max((uint64_t)1, endTime / 1000)
+            << " where " << name << "=1\n";
+    }
+    uint64_t rows = 0;
+    seconds = time_of(
+        [&]()
+        {
+            std::istringstream in(queries.str());
+            std::ostringstream out;
+            Batch batch(waveform.getWaveform());
+            batch.run(in, out);
+            std::string result = out.str();
+            rows = std::count(result.begin(), result.end(), '\n');
+        }
+    );
+    results.push_back(Result{"query", numQueries, seconds, numQueries / seconds, "queries/s"});
+    std::cerr << "query: " << results.back().rate << " queries/s (" << rows << " lines)\n";
+
+    // searches of the hierarchy like / in the menu
+    uint64_t searches = std::max((uint64_t)1, iterations / 100);
+    seconds = time_of(
+        [&]()
+        {
+            for (uint64_t i = 0; i < searches; i++)
+            {
+                const std::string& name = names[rng() % names.size()];
+                checksum += index.search(name.substr(name.rfind('.') + 1), 10).size();
+            }
+        }
+    );
+    results.push_back(Result{"search", searches, seconds, searches / seconds, "ops/s"});
+    std::cerr << "search: " << results.back().rate << " ops/s\n";
+
+    std::cout << "{\n  \"file\": " << json_string(path) << ",\n  \"bytes\": " << bytes << ",\n  \"signals\": "
+        << primitives.size() << ",\n  \"endTime\": " << endTime << ",\n  \"checksum\": " << checksum + characters
+        << ",\n  \"results\": [\n";
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        std::cout << "    {\"name\": " << json_string(results[i].name) << ", \"ops\": " << results[i].ops
+            << ", \"seconds\": " << results[i].seconds << ", \"rate\": " << results[i].rate << ", \"unit\": "
+            << json_string(results[i].unit) << "}" << ((i + 1 < results.size()) ? "," : "") << "\n";
+    }
+    std::cout << "  ]\n}\n";
+    return 0;
+}
@@ -0,0 +1,324 @@
+/**
+ * Author:          Cynthia Wang
+ * Date created:    10/19/2026
+ * Organization:    ECE 4122
+ *
+ * Description:
+ * Generator of synthetic VCD files for benchmarking Tabuwave, with a
+ * configurable number of signals, widths, unpacked arrays, activity and size.
+*/
+
+#include <getopt.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Options of the generated file.
+ */
+struct Options
+{
+    std::string path = "-";
+    size_t signals = 1000;       // vars outside arrays
+    size_t maxWidth = 64;        // widest vector var
+    size_t arrays = 8;           // unpacked arrays
+    size_t elements = 64;        // elements per array
+    size_t modules = 16;         // scopes under the top scope
+    uint64_t size = 64ULL << 20; // bytes to write, or 0 to stop after `steps`
+    uint64_t steps = 0;          // timesteps to write, or 0 to stop at `size`
+    double rate = 0.02;          // average fraction of vars changing per timestep
+    std::string activity = "uniform";
+    uint64_t seed = 1;
+};
+
+/**
+ * @brief A var of the generated file.
+ */
+struct Var
+{
+    std::string id;
+    size_t width;
+};
+
+/**
+ * @brief helper function to print usage text
+ */
+void print_help()
+{
+    std::cout << "gen_vcd [OPTIONS]\n";
+    std::cout << "  -o F\tOutput file (default - for stdout)\n";
+    std::cout << "  -n N\tNumber of vars outside arrays (default 1000)\n";
+    std::cout << "  -w N\tWidest vector var in bits (default 64); widths are 1 or powers of 2 up to N\n";
+    std::cout << "  -a N\tNumber of unpacked arrays (default 8)\n";
+    std::cout << "  -e N\tElements per unpacked array (default 64)\n";
+    std::cout << "  -m N\tNumber of module scopes the vars are spread over (default 16)\n";
+    std::cout << "  -s S\tStop after about S bytes, with an optional K, M or G suffix (default 64M)\n";
+    std::cout << "  -t N\tStop after N timesteps instead of at a size\n";
+    std::cout << "  -r R\tAverage fraction of vars changing per timestep (default 0.02)\n";
+    std::cout << "  -d D\tActivity: uniform, zipf (a few vars change most often) or burst\n";
+    std::cout << "  \t(alternating busy and idle periods) (default uniform)\n";
+    std::cout << "  -S N\tRandom seed (default 1)\n";
+}
+
+/**
+ * @brief helper function to parse a size with an optional K, M or G suffix
+ *
+ * @return true if the size is valid
+ */
+bool parse_size(const char* str, uint64_t& size)
+{
+    char* end;
+    size = strtoull(str, &end, 10);
+    if (end == str) return false;
+    switch (*end)
+    {
+        case 'G': case 'g': size <<= 30; end++; break;
+        case 'M': case 'm': size <<= 20; end++; break;
+        case 'K': case 'k': size <<= 10; end++; break;
+        default: break;
+    }
+    return *end == '\0';
+}
+
+/**
+ * @brief helper function to get the identifier code of the i-th var
+ */
+std::string identifier(size_t i)
+{
+    std::string id;
+    do
+    {
+        id += (char)(33 + i % 94);
+        i /= 94;
+    } while (i);
+    return id;
+}
+
+/**
+ * @brief Writes the generated file through a large buffer and counts the
+ * bytes written.
+ */
+class Writer
+{
+   private:
+    FILE* file;
+    std::string buffer;
+    uint64_t written;
+
+   public:
+    Writer(FILE* file) : file(file), written(0)
+    {
+        buffer.reserve(1 << 20);
+    }
+
+    ~Writer()
+    {
+        flush();
+    }
+
+    void write(const std::string& str)
+    {
+        buffer += str;
+        if (buffer.size() >= (1 << 20)) flush();
+    }
+
+    void flush()
+    {
+        fwrite(buffer.data(), 1, buffer.size(), file);
+        written += buffer.size();
+        buffer.clear();
+    }
+
+    uint64_t size()
+    {
+        return written + buffer.size();
+    }
+};
+
+/**
+ * @brief helper function to write a random value change of a var
+ */
+void write_change(Writer& out, const Var& var, std::mt19937_64& rng, std::string& line)
+{
+    line.clear();
+    if (var.width == 1)
+    {
+        line += (char)('0' + (rng() & 1));
+        line += var.id;
+    }
+    else
+    {
+        // leading zeros are left out, as simulators do
+        line += 'b';
+        bool leading = true;
+        uint64_t bits = 0;
+        for (size_t i = var.width; i-- > 0; )
+        {
+            if (i % 64 == 63 || i == var.width - 1) bits = rng();
+            char bit = (char)('0' + ((bits >> (i % 64)) & 1));
+            if (leading && bit == '0' && i) continue;
+            leading = false;
+            line += bit;
+        }
+        line += ' ';
+        line += var.id;
+    }
+    line += '\n';
+    out.write(line);
+}
+
+int main(int argc, char** argv)
+{
+    Options options;
+    int opt;
+    while (-1 != (opt = getopt(argc, argv, "o:n:w:a:e:m:s:t:r:d:S:h")))
+    {
+        switch (opt)
+        {
+            case 'o': options.path = optarg; break;
+            case 'n': options.signals = std::stoull(optarg); break;
+            case 'w': options.maxWidth = std::max(1ULL, std::stoull(optarg)); break;
+            case 'a': options.arrays = std::stoull(optarg); break;
+            case 'e': options.elements = std::max(1ULL, std::stoull(optarg)); break;
+            case 'm': options.modules = std::max(1ULL, std::stoull(optarg)); break;
+            case 's':
+                if (!parse_size(optarg, options.size))
+                {
+                    std::cerr << "Invalid size " << optarg << "\n";
+                    return 1;
+                }
+                break;
+            case 't': options.steps = std::stoull(optarg); options.size = 0; break;
+            case 'r': options.rate = std::stod(optarg); break;
+            case 'd': options.activity = optarg; break;
+            case 'S': options.seed = std::stoull(optarg); break;
+            case 'h':
+                /* Fall through */
+            default:
+                print_help();
+                return 0;
+        }
+    }
+    if (options.activity != "uniform" && options.activity != "zipf" && options.activity != "burst")
+    {
+        std::cerr << "Unknown activity " << options.activity << "\n";
+        return 1;
+    }
+    if (!options.size && !options.steps)
+    {
+        std::cerr << "Either a size or a number of timesteps is needed\n";
+        return 1;
+    }
+
+    FILE* file = (options.path == "-") ? stdout : fopen(options.path.c_str(), "wb");
+    if (!file)
+    {
+        std::cerr << "Could not open " << options.path << "\n";
+        return 1;
+    }
+    std::mt19937_64 rng(options.seed);
+    std::vector<size_t> widths{1};
+    for (size_t width = 8; width <= options.maxWidth; width *= 2)
+    {
+        widths.push_back(width);
+    }
+
+    // definitions: the clock in the top scope, and the vars and arrays spread
+    // over the modules
+    std::vector<Var> vars;
+    {
+        Writer out(file);
+        out.write("$version tabuwave gen_vcd $end\n$timescale 1ps $end\n$scope module top $end\n");
+        out.write("$var wire 1 ! clk $end\n");
+        for (size_t m = 0; m < options.modules; m++)
+        {
+            out.write("$scope module m" + std::to_string(m) + " $end\n");
+            for (size_t i = m; i < options.signals; i += options.modules)
+            {
+                // half scalars, the rest vectors of each width
+                size_t width = (rng() & 1) ? 1 : widths[rng() % widths.size()];
+                vars.push_back(Var{identifier(vars.size() + 1), width});
+                out.write("$var wire " + std::to_string(width) + " " + vars.back().id + " s" + std::to_string(i)
+                    + ((width > 1) ? " [" + std::to_string(width - 1) + ":0]" : "") + " $end\n");
+            }
+            for (size_t a = m; a < options.arrays; a += options.modules)
+            {
+                size_t width = widths[rng() % widths.size()];
+                for (size_t e = 0; e < options.elements; e++)
+                {
+                    vars.push_back(Var{identifier(vars.size() + 1), width});
+                    out.write("$var wire " + std::to_string(width) + " " + vars.back().id + " mem" + std::to_string(a)
+                        + "[" + std::to_string(e) + "]" + ((width > 1) ? " [" + std::to_string(width - 1) + ":0]" : "")
+                        + " $end\n");
+                }
+            }
+            out.write("$upscope $end\n");
+        }
+        out.write("$upscope $end\n$enddefinitions $end\n");
+
+        std::string line;
+        out.write("#0\n$dumpvars\n0!\n");
+        for (auto& var : vars)
+        {
+            write_change(out, var, rng, line);
+        }
+        out.write("$end\n");
+
+        // zipf: var i changes with probability proportional to 1 / (i + 1)
+        std::vector<double> zipf;
+        if (options.activity == "zipf")
+        {
+            double sum = 0;
+            for (size_t i = 0; i < vars.size(); i++)
+            {
+                sum += 1.0 / (i + 1);
+                zipf.push_back(sum);
+            }
+        }
+
+        // value changes, with the clock toggling every timestep
+        std::uniform_real_distribution<double> uniform(0, 1);
+        double mean = options.rate * vars.size();
+        uint64_t burstLeft = 0;
+        bool busy = false;
+        for (uint64_t t = 1; options.steps ? (t < options.steps) : (out.size() < options.size); t++)
+        {
+            out.write("#" + std::to_string(t) + "\n" + (char)('0' + (t & 1)) + "!\n");
+            double stepMean = mean;
+            if (options.activity == "burst")
+            {
+                // busy periods are 10 times as active as idle ones
+                if (!burstLeft)
+                {
+                    busy = !busy;
+                    burstLeft = 1 + rng() % 1000;
+                }
+                burstLeft--;
+                stepMean *= busy ? 10 : 0.1;
+            }
+            std::poisson_distribution<uint64_t> changes(std::max(stepMean, 1e-9));
+            uint64_t count = std::min((uint64_t)vars.size(), changes(rng));
+            for (uint64_t c = 0; c < count; c++)
+            {
+                size_t i;
+                if (zipf.empty())
+                {
+                    i = rng() % vars.size();
+                }
+                else
+                {
+                    i = std::lower_bound(zipf.begin(), zipf.end(), uniform(rng) * zipf.back()) - zipf.begin();
+                    i = std::min(i, vars.size() - 1);
+                }
+                write_change(out, vars[i], rng, line);
+            }
+        }
+    }
+    if (file != stdout) fclose(file);
+    return 0;
+}
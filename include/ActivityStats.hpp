@@ -0,0 +1,110 @@
+/**
+ * Author:          Cynthia Wang
+ * Date created:    10/19/2026
+ * Organization:    ECE 4122
+ *
+ * Description:
+ * Header file for ActivityStats class, an analytics pass computing how
+ * active each index of a set of signals was over a run.
+*/
+
+#ifndef __ACTIVITY_STATS_HPP
+#define __ACTIVITY_STATS_HPP
+
+#include <shared_mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Vcd.hpp"
+
+/**
+ * @brief Computes activity statistics of signals over a run directly from
+ * their published values, in parallel across signals and array elements.
+ * An index of a var is one bit; an index of an unpacked array is an
+ * element, which is counted as active while its value is nonzero.
+ */
+class ActivityStats
+{
+   public:
+    /**
+     * @brief Data structure for the statistics of a signal.
+     */
+    struct Signal
+    {
+        std::string name;
+        std::vector<uint64_t> toggles;    // changes between known values of each index
+        std::vector<uint64_t> activeTime; // time each index was 1 or nonzero
+        uint64_t peakOccupancy;           // most indices active at once
+        uint64_t peakTime;                // first time of the peak occupancy
+        double averageOccupancy;          // active indices averaged over time
+    };
+
+   private:
+    std::shared_mutex* valuesMutex; // guards the values being read, if any
+    std::vector<Signal> signals;
+    uint64_t endTime;
+    double seconds;
+
+    /**
+     * @brief Computes the statistics of every index of a var, where each
+     * index is one bit, and its occupancy.
+     */
+    static void computeVar(VcdVar* var, uint64_t endTime, Signal& stats);
+
+    /**
+     * @brief Computes the statistics of one element of an unpacked array,
+     * and the times it becomes active (+1) or inactive (-1).
+     */
+    static void computeElement(VcdVar* element, size_t index, uint64_t endTime, Signal& stats,
+        std::vector<std::pair<uint64_t, int>>& events);
+
+   public:
+    /**
+     * @brief Construct a new ActivityStats object with no statistics.
+     */
+    ActivityStats() : valuesMutex(nullptr), endTime(0), seconds(0)
+    {}
+
+    /**
+     * @brief Sets the mutex to hold shared while reading values, for when
+     * the values may still be written by a parser running in the background.
+     *
+     * @param mutex (std::shared_mutex*) mutex guarding the values
+     */
+    void setValuesMutex(std::shared_mutex* mutex);
+
+    /**
+     * @brief Computes the statistics of signals from time 0 to `endTime`.
+     * Vars and array elements are spread over threads.
+     *
+     * @param columns (const std::vector<std::pair<std::string, VcdPrimitive*>>&)
+     * signals as pairs of name and primitive; only vars and unpacked arrays
+     * are computed
+     * @param endTime (uint64_t) last time of the run
+     */
+    void compute(const std::vector<std::pair<std::string, VcdPrimitive*>>& columns, uint64_t endTime);
+
+    /**
+     * @brief Get the statistics of each signal computed.
+     *
+     * @return const std::vector<Signal>& statistics
+     */
+    const std::vector<Signal>& getSignals();
+
+    /**
+     * @brief Get the last time the statistics were computed up to.
+     *
+     * @return uint64_t end time
+     */
+    uint64_t getEndTime();
+
+    /**
+     * @brief Get the time the last computation took.
+     *
+     * @return double seconds
+     */
+    double getSeconds();
+};
+
+#endif
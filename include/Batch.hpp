@@ -0,0 +1,178 @@
+/**
+ * Author:          Cynthia Wang
+ * Date created:    10/19/2026
+ * Organization:    ECE 4122
+ *
+ * Description:
+ * Header file for Batch class, which answers a list of table queries
+ * from one parsed waveform without the TUI.
+*/
+
+#ifndef __BATCH_HPP
+#define __BATCH_HPP
+
+#include <sys/types.h>
+#include <cstdio>
+#include <istream>
+#include <map>
+#include <ostream>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Vcd.hpp"
+#include "Waveform.hpp"
+
+/**
+ * @brief Answers table queries read one per line, each printed as the
+ * rows of the table at the times it asks for. A query is
+ *
+ *     <signals> at <time>[,<time>...] [where <query_str>]
+ *     <signals> from <time> to <time> [every <N>] [where <query_str>]
+ *
+ * where `<signals>` are comma-separated hierarchical names, times and N
+ * are in units of the timescale, a range is sampled at every change of its
+ * signals unless `every` is given, and `<query_str>` has the syntax of the
+ * `?` command of table mode over the hierarchical names, keeping only the
+ * indices that satisfy it. Empty lines and lines starting with `#` are
+ * skipped.
+ *
+ * All the sample times of all the queries are answered in one forward
+ * sweep in time order, so values decoded for one query are reused by the
+ * others at the same time, and results are printed in the order of the
+ * queries, each as a `#` line with the query followed by tab-separated
+ * rows of time, index and the value of each signal. Each query generates
+ * its sample times as the sweep reaches them, and the rows of the first
+ * query not yet printed in full are printed as they are answered, while
+ * the rows of later queries wait in memory, or in a temporary file once
+ * they grow large, so memory use does not depend on the length of the
+ * output.
+ */
+class Batch
+{
+   private:
+    /**
+     * @brief Data structure for a parsed query and its results.
+     */
+    struct Query
+    {
+        std::string text;
+        std::vector<std::pair<std::string, VcdPrimitive*>> columns;
+        std::map<std::string, std::set<std::string>> conditions; // allowed values of each column
+        size_t rows;                 // number of indices of the table
+        std::string error;
+
+        // sample times, generated as the sweep reaches them
+        std::vector<uint64_t> times; // of an `at` query, sorted
+        bool range;                  // `from` query: start, end and period
+        uint64_t start;
+        uint64_t end;
+        uint64_t period;             // 0 to sample at every change of the signals
+        size_t pos;                  // position in times of the next sample
+        uint64_t time;               // next sample time
+        bool finished;               // every sample answered
+
+        std::string output;          // rows waiting to be printed
+        std::vector<std::pair<off_t, size_t>> spooled; // offset and length of rows moved to the spool
+    };
+
+    /**
+     * @brief Data structure for the last decoded values of a signal.
+     */
+    struct Decoded
+    {
+        uint64_t time;
+        std::vector<std::string> values;
+    };
+
+    Waveform* parser;
+    uint64_t timescaleMultiplier;
+    std::string timescaleUnit;
+    std::vector<Query> queries;
+    std::map<VcdPrimitive*, Decoded> decoded;
+
+    // rows of queries after the current one wait to be printed, in memory
+    // until there are SPOOL_BYTES of them and then in a temporary file
+    static constexpr size_t SPOOL_BYTES = 4 << 20;
+    std::ostream* out;
+    size_t current;   // first query not printed in full, whose rows are printed as answered
+    size_t buffered;  // bytes of rows waiting in memory
+    std::FILE* spool;
+    off_t spoolEnd;
+
+    /**
+     * @brief Parses a query line, setting `query.error` on error.
+     */
+    void parseQuery(const std::string& line, Query& query);
+
+    /**
+     * @brief Parses a time in units of the timescale.
+     *
+     * @return true on success, false if `str` is not a number
+     */
+    bool parseTime(const std::string& str, uint64_t& time);
+
+    /**
+     * @brief Get the values of every index of a signal at a time, decoding
+     * them only if the last decoded time differs.
+     */
+    const std::vector<std::string>& valuesAt(VcdPrimitive* primitive, uint64_t time);
+
+    /**
+     * @brief Sets the first sample time of a query, or marks it finished if
+     * it has none.
+     */
+    void startSamples(Query& query);
+
+    /**
+     * @brief Advances a query to its next sample time, or marks it finished
+     * if it has no more.
+     */
+    void nextSample(Query& query);
+
+    /**
+     * @brief Prints the rows of a query at a time if it is the current
+     * query, or keeps them to print later.
+     */
+    void answer(Query& query, uint64_t time);
+
+    /**
+     * @brief Moves the rows waiting in memory to the spool file, or keeps
+     * them in memory if it cannot be written.
+     */
+    void spoolOutput();
+
+    /**
+     * @brief Prints the header of a query and the rows kept for it so far.
+     */
+    void printKept(Query& query);
+
+    /**
+     * @brief Finishes printing the current query and the queries after it
+     * while they are finished, printing what was kept for the next one.
+     */
+    void printFinished();
+
+   public:
+    /**
+     * @brief Construct a new Batch object over a parsed waveform.
+     *
+     * @param parser (Waveform*) waveform that has finished parsing
+     */
+    Batch(Waveform* parser);
+
+    ~Batch();
+
+    /**
+     * @brief Reads queries until the end of the input, answers them and
+     * prints the results.
+     *
+     * @param in (std::istream&) queries, one per line
+     * @param out (std::ostream&) stream to print the results to
+     * @return size_t number of queries that could not be answered
+     */
+    size_t run(std::istream& in, std::ostream& out);
+};
+
+#endif
@@ -0,0 +1,227 @@
+/**
+ * Author:          Cynthia Wang
+ * Date created:    10/19/2026
+ * Organization:    ECE 4122
+ *
+ * Description:
+ * Header file for DerivedColumn class, a table column computed from an
+ * expression over other columns.
+*/
+
+#ifndef __DERIVED_COLUMN_HPP
+#define __DERIVED_COLUMN_HPP
+
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "Vcd.hpp"
+
+/**
+ * @brief A column of the table computed from an expression over other
+ * columns, such as `valid & ~stall` or `|entry_state`. Values of all
+ * indices are evaluated at once as packed bit vectors, so each operator
+ * is a loop of word operations, and evaluated values are cached per time.
+ *
+ * Operators, from highest to lowest precedence, are the unary `~` (not),
+ * `&`, `|`, `^` (reduction of the bits of each index's value), the binary
+ * `==` and `!=` (comparison of each index's values), `&`, `^` and `|`.
+ * Operands are columns, constants (decimal, `h` hex or `b` binary), or
+ * parenthesized expressions. Operands of different sizes are extended
+ * with zeros, and constants apply to every index.
+ */
+class DerivedColumn : public VcdPrimitive
+{
+   private:
+    /**
+     * @brief Values of all indices of a column packed into bit planes.
+     * Bit b of the value at index i is bit i % 64 of planes[b][i / 64].
+     */
+    struct Bits
+    {
+        size_t rows; // number of indices, or 0 for a constant applying to every index
+        std::vector<std::vector<uint64_t>> planes;
+        std::vector<uint64_t> unknown; // indices whose value has an x or z bit
+
+        /**
+         * @brief Get a word of a plane, which is 0 past the width or the
+         * last index and the same for every word of a constant.
+         */
+        inline uint64_t word(size_t b, size_t w) const
+        {
+            if (b >= planes.size()) return 0;
+            if (!rows) return planes[b][0];
+            return (w < planes[b].size()) ? planes[b][w] : 0;
+        }
+
+        /**
+         * @brief Get a word of the unknown mask, which is the same for
+         * every word of a constant.
+         */
+        inline uint64_t unknownWord(size_t w) const
+        {
+            if (!rows) return unknown[0];
+            return (w < unknown.size()) ? unknown[w] : 0;
+        }
+    };
+
+    /**
+     * @brief Node of a parsed expression.
+     */
+    struct Expr
+    {
+        enum Op { COLUMN, CONSTANT, NOT, REDUCE_AND, REDUCE_OR, REDUCE_XOR, EQ, NE, AND, XOR, OR };
+        Op op;
+        VcdPrimitive* column;
+        std::shared_ptr<const Bits> constant;
+        std::unique_ptr<Expr> lhs;
+        std::unique_ptr<Expr> rhs;
+        size_t rows;  // number of indices of the result
+        size_t width; // bits per index of the result
+    };
+
+    std::unique_ptr<Expr> expr;
+    std::string expression;
+    std::vector<VcdPrimitive*> columns; // columns the expression uses
+    std::string error;
+
+    // recently evaluated times
+    std::mutex cacheMutex;
+    std::map<uint64_t, std::shared_ptr<const Bits>> cache;
+    std::deque<uint64_t> cacheOrder;
+    static const size_t CACHE_SIZE = 16;
+
+    // state of the expression parser
+    std::string input;
+    size_t pos;
+
+    /**
+     * @brief Recursive descent parsers for each precedence level of the
+     * expression, from lowest to highest. On error, set `error` and return
+     * nullptr.
+     */
+    std::unique_ptr<Expr> parseOr(const std::map<std::string, VcdPrimitive*>& available);
+    std::unique_ptr<Expr> parseXor(const std::map<std::string, VcdPrimitive*>& available);
+    std::unique_ptr<Expr> parseAnd(const std::map<std::string, VcdPrimitive*>& available);
+    std::unique_ptr<Expr> parseEquality(const std::map<std::string, VcdPrimitive*>& available);
+    std::unique_ptr<Expr> parseUnary(const std::map<std::string, VcdPrimitive*>& available);
+    std::unique_ptr<Expr> parsePrimary(const std::map<std::string, VcdPrimitive*>& available);
+
+    /**
+     * @brief Skips spaces and checks whether the input continues with `token`,
+     * consuming it if so.
+     */
+    bool accept(const char* token);
+
+    /**
+     * @brief Makes a node for a binary operator, sized to fit both operands.
+     */
+    static std::unique_ptr<Expr> binary(Expr::Op op, std::unique_ptr<Expr> lhs, std::unique_ptr<Expr> rhs);
+
+    /**
+     * @brief Packs the values of a column at a time into bit planes.
+     */
+    static std::shared_ptr<const Bits> load(VcdPrimitive* column, uint64_t time);
+
+    /**
+     * @brief Evaluates an expression node at a time.
+     */
+    static std::shared_ptr<const Bits> evaluate(const Expr& node, uint64_t time);
+
+    /**
+     * @brief Get the evaluated values at a time, evaluating them if they
+     * are not cached. Safe to call from several threads.
+     */
+    std::shared_ptr<const Bits> valuesAt(uint64_t time);
+
+   public:
+    /**
+     * @brief Construct a new DerivedColumn object with no expression.
+     *
+     * @param name (const std::string&) name of the column
+     */
+    DerivedColumn(const std::string& name);
+
+    /**
+     * @brief Parses the expression of the column.
+     *
+     * @param expression (const std::string&) expression to parse
+     * @param available (const std::map<std::string, VcdPrimitive*>&) columns
+     * the expression may use, by name
+     * @return true on success, false on error; see `getError`
+     */
+    bool parse(const std::string& expression, const std::map<std::string, VcdPrimitive*>& available);
+
+    /**
+     * @brief Get the reason the last call to `parse` failed.
+     *
+     * @return const std::string& error message
+     */
+    const std::string& getError();
+
+    /**
+     * @brief Get the expression of the column.
+     *
+     * @return const std::string& expression
+     */
+    const std::string& getExpression();
+
+    /**
+     * @brief Check whether the expression uses a column.
+     *
+     * @param column (VcdPrimitive*) column to check
+     * @return true if the expression uses column
+     */
+    bool uses(VcdPrimitive* column);
+
+    /**
+     * @brief Get the number of indices of the column.
+     *
+     * @return size_t size
+     */
+    size_t getSize();
+
+    /**
+     * @brief Get the width of the column when displayed in a table.
+     *
+     * @return size_t width
+     */
+    size_t getWidth();
+
+    /**
+     * @brief Get the value of the column at the specified time.
+     *
+     * @param time (uint64_t) time to query, unit based on VCD file's timescale.
+     * @param size (size_t) size to pad vector to.
+     * @return const std::vector<std::string> vector containing the column's
+     * value; each element represents the value at an index.
+     */
+    const std::vector<std::string> getValueAt(uint64_t time, size_t size);
+
+    /**
+     * @brief Get the value of the column at the specified time for a window
+     * of indices. Values of every index are evaluated at once and cached.
+     *
+     * @param time (uint64_t) time to query, unit based on VCD file's timescale.
+     * @param start (size_t) first index to retrieve.
+     * @param count (size_t) number of indices to retrieve.
+     * @return const std::vector<std::string> vector of `count` elements.
+     */
+    const std::vector<std::string> getValueWindow(uint64_t time, size_t start, size_t count);
+
+    /**
+     * @brief Get the time of the first change of any column the expression
+     * uses after the specified time, which is when the value of the column
+     * may change next.
+     *
+     * @param time (uint64_t) time to query, unit based on VCD file's timescale.
+     * @return uint64_t time of the next change, or (uint64_t)-1 if there is
+     * none
+     */
+    uint64_t getNextChange(uint64_t time);
+};
+
+#endif
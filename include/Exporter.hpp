@@ -0,0 +1,224 @@
+/**
+ * Author:          Cynthia Wang
+ * Date created:    10/19/2026
+ * Organization:    ECE 4122
+ *
+ * Description:
+ * Header file for Exporter class, which streams the values of a set of
+ * signals over a time range to a CSV, JSON lines or binary file.
+*/
+
+#ifndef __EXPORTER_HPP
+#define __EXPORTER_HPP
+
+#include <ostream>
+#include <shared_mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Vcd.hpp"
+
+/**
+ * @brief Streams the values of a set of signals over a time range, one row
+ * per sample time. Samples are taken at every change of any signal, at
+ * every rising edge of a clock, or every N units. Rows are produced by a
+ * k-way merge of the next change times of the signals, so memory does not
+ * depend on the length of the range and each signal is only read when it
+ * changes.
+ *
+ * Each var is one column holding its value in hex (or its bit, for a
+ * single bit var), and each element of an unpacked array or index of a
+ * derived column is one column `name[i]`. Times are written in the unit of
+ * the timescale.
+ *
+ * The binary format is little-endian, with integers as LEB128 varints and
+ * strings as a varint length followed by the bytes:
+ *
+ *     "TBWX" version(u8 = 1) unit(string) columns(varint) name(string)...
+ *     blocks, each:
+ *         rows(varint, at most BLOCK_ROWS)
+ *         times of the rows as varint deltas from the previous row, the
+ *             first row of the file from 0
+ *         for each column: a bitmap of ceil(rows / 8) bytes with bit r % 8
+ *             of byte r / 8 set if row r has a new value, followed by the
+ *             new values as strings; the first row of a block always has
+ *             one so blocks can be decoded alone
+ *     rows(varint = 0) ending the file
+ */
+class Exporter
+{
+   public:
+    enum Format { CSV, JSONL, BINARY };
+
+    /**
+     * @brief Data structure for what and how to export.
+     */
+    struct Options
+    {
+        Format format;
+        uint64_t startTime;           // first time, unit based on VCD file's timescale
+        uint64_t endTime;             // last time, unit based on VCD file's timescale
+        uint64_t period;              // sample every period units if nonzero
+        VcdPrimitive* clock;          // sample at rising edges of clock if set
+        uint64_t timescaleMultiplier; // times are written multiplied by this
+        std::string timescaleUnit;
+    };
+
+    static const size_t BLOCK_ROWS = 4096;
+
+   private:
+    /**
+     * @brief Data structure for a var, array element or derived column
+     * whose changes are merged, and the columns it provides.
+     */
+    struct Source
+    {
+        VcdPrimitive* primitive;
+        VcdVar* var;   // var providing one column, or nullptr if primitive provides count
+        size_t column; // first column
+        size_t count;  // number of columns
+    };
+
+    std::shared_mutex* valuesMutex; // guards the values being read, if any
+    std::vector<std::string> names; // name of each column
+    std::vector<Source> sources;
+    std::string error;
+    uint64_t rows;
+    double seconds;
+
+    // state of the current export
+    std::vector<std::string> values;       // value of each column
+    std::vector<bool> changed;             // columns with a new value since the last row
+    std::vector<std::string> keys;         // quoted JSON key of each column
+    std::string line;                      // row being formatted
+    std::string blockTimes;                // encoded times of the current binary block
+    std::vector<std::string> blockValues;  // encoded new values of each column of the block
+    std::vector<std::string> blockBitmaps; // bitmap of each column of the block
+    size_t blockRows;
+    uint64_t lastTime;                     // time of the last row written, as written
+
+    /**
+     * @brief Loads the values of a source at a time, marking the columns
+     * whose value changed.
+     *
+     * @return true if any value changed
+     */
+    bool load(Source& source, uint64_t time);
+
+    /**
+     * @brief Writes the start of the file, such as the CSV header.
+     */
+    void writeHeader(std::ostream& out, const Options& options);
+
+    /**
+     * @brief Writes a row of the current values.
+     */
+    void writeRow(std::ostream& out, const Options& options, uint64_t time);
+
+    /**
+     * @brief Writes the rows of the current binary block and starts a new one.
+     */
+    void flushBlock(std::ostream& out);
+
+    /**
+     * @brief Appends an unsigned LEB128 varint to a buffer.
+     */
+    static void appendVarint(std::string& buffer, uint64_t value);
+
+    /**
+     * @brief Appends a length-prefixed string to a buffer.
+     */
+    static void appendString(std::string& buffer, const std::string& str);
+
+    /**
+     * @brief Appends a string to a buffer as a quoted JSON string.
+     */
+    static void appendJson(std::string& buffer, const std::string& str);
+
+    /**
+     * @brief Appends a string to a buffer as a CSV field, quoted if needed.
+     */
+    static void appendCsv(std::string& buffer, const std::string& str);
+
+    /**
+     * @brief Check whether a single bit primitive is 1 at a time.
+     */
+    static bool isHigh(VcdPrimitive* clock, uint64_t time);
+
+   public:
+    /**
+     * @brief Construct a new Exporter object with no columns.
+     */
+    Exporter() : valuesMutex(nullptr), rows(0), seconds(0), blockRows(0), lastTime(0)
+    {}
+
+    /**
+     * @brief Sets the mutex to hold shared while reading values, for when
+     * the values may still be written by a parser running in the background.
+     * It is released between blocks of rows so long exports do not hold up
+     * the parser.
+     *
+     * @param mutex (std::shared_mutex*) mutex guarding the values
+     */
+    void setValuesMutex(std::shared_mutex* mutex);
+
+    /**
+     * @brief Sets the signals to export.
+     *
+     * @param columns (const std::vector<std::pair<std::string, VcdPrimitive*>>&)
+     * signals as pairs of name and primitive, in the order of the columns
+     */
+    void setColumns(const std::vector<std::pair<std::string, VcdPrimitive*>>& columns);
+
+    /**
+     * @brief Writes the values of the columns from `options.startTime` to
+     * `options.endTime`, which must not be past the parsed values.
+     *
+     * @param out (std::ostream&) stream to write to
+     * @param options (const Options&) what and how to export
+     * @return true on success, false on error; see `getError`
+     */
+    bool write(std::ostream& out, const Options& options);
+
+    /**
+     * @brief Parses an export command like `out.csv every 10 from 100 to 500`.
+     * The first word is the path; the rest are the format (`csv`, `jsonl` or
+     * `bin`, otherwise taken from the extension of the path), and the
+     * optional `every <N>`, `edge <clock>`, `from <time>` and `to <time>`,
+     * with times and N in units of the timescale. Fields not given are left
+     * unchanged in `options`.
+     *
+     * @param command (const std::string&) command to parse
+     * @param options (Options&) options to fill in; the timescale must be set
+     * @param path (std::string&) set to the path
+     * @param clockName (std::string&) set to the name of the clock if given
+     * @param error (std::string&) set to the reason on error
+     * @return true on success, false on error
+     */
+    static bool parseCommand(const std::string& command, Options& options, std::string& path,
+        std::string& clockName, std::string& error);
+
+    /**
+     * @brief Get the reason the last call to `write` failed.
+     *
+     * @return const std::string& error message
+     */
+    const std::string& getError();
+
+    /**
+     * @brief Get the number of rows the last call to `write` wrote.
+     *
+     * @return uint64_t rows
+     */
+    uint64_t getRows();
+
+    /**
+     * @brief Get the time the last call to `write` took.
+     *
+     * @return double seconds
+     */
+    double getSeconds();
+};
+
+#endif
@@ -0,0 +1,153 @@
+/**
+ * Author:          Cynthia Wang
+ * Date created:    10/19/2026
+ * Organization:    ECE 4122
+ *
+ * Description:
+ * Header file for FrameCache class, a bounded LRU cache of decoded table
+ * frames with background prefetching of neighbouring timestamps.
+*/
+
+#ifndef __FRAME_CACHE_HPP
+#define __FRAME_CACHE_HPP
+
+#include <condition_variable>
+#include <deque>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Vcd.hpp"
+
+/**
+ * @brief Bounded LRU cache of decoded table frames keyed by time. A frame
+ * holds the values of a window of rows for a set of columns at one time.
+ * Tasks on the `ThreadPool` prefetch the frames around the current time in
+ * the direction the user is moving so that sequential stepping is a cache
+ * hit.
+ */
+class FrameCache
+{
+   public:
+    /**
+     * @brief Values of each column of the window, keyed by column name.
+     */
+    typedef std::map<std::string, std::vector<std::string>> Frame;
+
+    /**
+     * @brief Columns of the window, as pairs of name and primitive.
+     */
+    typedef std::vector<std::pair<std::string, VcdPrimitive*>> Columns;
+
+   private:
+    /**
+     * @brief Data structure for a cached frame and its position in the
+     * LRU list.
+     */
+    struct Entry
+    {
+        std::shared_ptr<const Frame> frame;
+        std::list<uint64_t>::iterator lruPos;
+    };
+
+    size_t capacity;
+    size_t prefetchDepth;
+
+    std::mutex mutex;
+    std::condition_variable tasksDone;
+    bool stopping;
+    size_t maxTasks; // prefetch tasks run at once, 0 to not prefetch
+    size_t runningTasks;
+    std::shared_mutex* valuesMutex; // guards the values being decoded, if any
+
+    // window that frames are decoded for; changing it invalidates the cache
+    Columns columns;
+    size_t start;
+    size_t count;
+    uint64_t generation;
+
+    std::unordered_map<uint64_t, Entry> entries;
+    std::list<uint64_t> lru;            // most recently used at the front
+    std::deque<uint64_t> pending;       // times waiting to be prefetched
+
+    /**
+     * @brief Decodes the frame at `time` for the given window. Does not
+     * touch any state guarded by `mutex` so it can run without holding it,
+     * but holds `valuesMutex` shared if one was set.
+     */
+    std::shared_ptr<const Frame> decode(const Columns& columns, size_t start, size_t count, uint64_t time);
+
+    /**
+     * @brief Inserts a frame as most recently used, evicting the least
+     * recently used frame if the cache is full. Must hold the lock.
+     */
+    void insert(uint64_t time, std::shared_ptr<const Frame> frame);
+
+    /**
+     * @brief Task run on the pool, decoding pending times until none are
+     * left or the cache is being destroyed.
+     */
+    void prefetchTask();
+
+   public:
+    /**
+     * @brief Construct a new FrameCache object. Frames are prefetched on the
+     * workers of the `ThreadPool`, if it has any.
+     *
+     * @param capacity (size_t) maximum number of frames kept
+     * @param prefetchDepth (size_t) number of frames prefetched ahead of the
+     * current time
+     */
+    FrameCache(size_t capacity = 128, size_t prefetchDepth = 16);
+
+    /**
+     * @brief Destroy the FrameCache object, waiting for prefetch tasks in
+     * progress.
+     */
+    ~FrameCache();
+
+    /**
+     * @brief Sets the mutex to hold shared while decoding values, for when
+     * the values may still be written by a parser running in the background.
+     *
+     * @param mutex (std::shared_mutex*) mutex guarding the values
+     */
+    void setValuesMutex(std::shared_mutex* mutex);
+
+    /**
+     * @brief Sets the window frames are decoded for. If it differs from the
+     * current window, cached frames and pending prefetches are dropped.
+     *
+     * @param columns (const Columns&) columns of the window
+     * @param start (size_t) first index of the window
+     * @param count (size_t) number of indices in the window
+     */
+    void setWindow(const Columns& columns, size_t start, size_t count);
+
+    /**
+     * @brief Get the frame at `time` for the current window, decoding it
+     * synchronously on a cache miss.
+     *
+     * @param time (uint64_t) time of the frame
+     * @return std::shared_ptr<const Frame> decoded frame
+     */
+    std::shared_ptr<const Frame> get(uint64_t time);
+
+    /**
+     * @brief Queues the frames around `time` for prefetching, most of them
+     * in `direction`.
+     *
+     * @param time (uint64_t) current time
+     * @param direction (int) 1 if moving forward, -1 if moving backward, 0
+     * if unknown
+     * @param maxTime (uint64_t) last time that can be prefetched
+     */
+    void prefetch(uint64_t time, int direction, uint64_t maxTime);
+};
+
+#endif
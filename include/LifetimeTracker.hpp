@@ -0,0 +1,145 @@
+/**
+ * Author:          Cynthia Wang
+ * Date created:    10/19/2026
+ * Organization:    ECE 4122
+ *
+ * Description:
+ * Header file for LifetimeTracker class, which finds how long each entry
+ * of a scoreboard or buffer stays allocated over a run.
+*/
+
+#ifndef __LIFETIME_TRACKER_HPP
+#define __LIFETIME_TRACKER_HPP
+
+#include <shared_mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Vcd.hpp"
+
+/**
+ * @brief Finds every allocation-to-release interval of each index of a
+ * valid signal over a run. An index is allocated while it is 1 (or
+ * nonzero, for an element of an unpacked array). Provides latency
+ * percentiles, a histogram and the longest-lived entries.
+ */
+class LifetimeTracker
+{
+   public:
+    /**
+     * @brief Data structure for one lifetime of an index.
+     */
+    struct Lifetime
+    {
+        size_t index;
+        uint64_t start; // time the index was allocated
+        uint64_t end;   // time the index was released, or the end of the run plus 1 if still allocated
+        bool open;      // still allocated at the end of the run
+        uint64_t length() const { return end - start; }
+    };
+
+   private:
+    std::shared_mutex* valuesMutex; // guards the values being read, if any
+    std::vector<Lifetime> lifetimes; // sorted longest first
+    std::vector<uint64_t> lengths;   // lengths of closed lifetimes, sorted
+    uint64_t endTime;
+    double seconds;
+
+    /**
+     * @brief Sweeps the values of a var for indices [first, last), where
+     * each index is one bit.
+     */
+    static void sweepVar(VcdVar* var, size_t first, size_t last, uint64_t endTime, std::vector<Lifetime>& out);
+
+    /**
+     * @brief Sweeps the values of one element of an unpacked array.
+     */
+    static void sweepElement(VcdVar* element, size_t index, uint64_t endTime, std::vector<Lifetime>& out);
+
+    /**
+     * @brief Sweeps any primitive, such as a derived column, by retrieving
+     * its values at each time it may change.
+     */
+    static void sweepPrimitive(VcdPrimitive* primitive, uint64_t endTime, std::vector<Lifetime>& out);
+
+   public:
+    /**
+     * @brief Construct a new LifetimeTracker object with no lifetimes.
+     */
+    LifetimeTracker() : valuesMutex(nullptr), endTime(0), seconds(0)
+    {}
+
+    /**
+     * @brief Sets the mutex to hold shared while reading values, for when
+     * the values may still be written by a parser running in the background.
+     *
+     * @param mutex (std::shared_mutex*) mutex guarding the values
+     */
+    void setValuesMutex(std::shared_mutex* mutex);
+
+    /**
+     * @brief Finds the lifetimes of every index of `valid` from time 0 to
+     * `endTime` in one pass over its values. Indices of a var are split
+     * over threads, as are the elements of an unpacked array.
+     *
+     * @param valid (VcdPrimitive*) valid signal, or allocate condition
+     * @param endTime (uint64_t) last time of the run
+     */
+    void compute(VcdPrimitive* valid, uint64_t endTime);
+
+    /**
+     * @brief Get the lifetimes found, longest first.
+     *
+     * @return const std::vector<Lifetime>& lifetimes
+     */
+    const std::vector<Lifetime>& getLifetimes();
+
+    /**
+     * @brief Get the number of lifetimes that ended before the end of the run.
+     *
+     * @return size_t number of closed lifetimes
+     */
+    size_t getClosedCount();
+
+    /**
+     * @brief Get a percentile of the lengths of the closed lifetimes.
+     *
+     * @param percent (double) percentile, from 0 to 100
+     * @return uint64_t length, or 0 if there are none
+     */
+    uint64_t getPercentile(double percent);
+
+    /**
+     * @brief Get the mean length of the closed lifetimes.
+     *
+     * @return double mean length, or 0 if there are none
+     */
+    double getMean();
+
+    /**
+     * @brief Get a histogram of the lengths of the closed lifetimes with
+     * bins of powers of two, since latencies are usually long-tailed.
+     *
+     * @return std::vector<std::pair<uint64_t, size_t>> pairs of the lower
+     * bound of each bin and the number of lifetimes in it, from the bin of
+     * the shortest lifetime to the bin of the longest
+     */
+    std::vector<std::pair<uint64_t, size_t>> getHistogram();
+
+    /**
+     * @brief Get the last time the lifetimes were computed up to.
+     *
+     * @return uint64_t end time
+     */
+    uint64_t getEndTime();
+
+    /**
+     * @brief Get the time the last computation took.
+     *
+     * @return double seconds
+     */
+    double getSeconds();
+};
+
+#endif
@@ -0,0 +1,144 @@
+/**
+ * Author:          Cynthia Wang
+ * Date created:    10/19/2026
+ * Organization:    ECE 4122
+ *
+ * Description:
+ * Header file for LoadStats class, which records statistics of loading a
+ * waveform for the startup screen and for `--stats`.
+*/
+
+#ifndef __LOAD_STATS_HPP
+#define __LOAD_STATS_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Statistics of loading a waveform: wall and CPU time of each phase
+ * of parsing, the amount of input and of parsed data, the work done by
+ * each thread constructing value intervals, and the peak memory used.
+ * Written by the `Parser` that owns it, and read once parsing is done.
+ */
+class LoadStats
+{
+   public:
+    /**
+     * @brief A phase of loading.
+     */
+    struct Phase
+    {
+        std::string name;
+        double wallSeconds;
+        double cpuSeconds; // of the whole process, so it includes other threads
+    };
+
+    /**
+     * @brief Work done by one thread constructing value intervals, summed
+     * over every publish.
+     */
+    struct ThreadWork
+    {
+        uint64_t vars;    // vars with new values
+        uint64_t changes; // value changes turned into intervals
+        double seconds;   // time busy
+    };
+
+   private:
+    std::vector<Phase> phases;
+    std::string phaseName; // phase in progress, or empty
+    std::chrono::steady_clock::time_point phaseStart;
+    double phaseCpuStart;
+    double phaseTraceStart; // start in the trace, if tracing
+
+    std::vector<ThreadWork> threadWork;
+
+    uint64_t files;
+    uint64_t bytes;
+    uint64_t valueChanges;
+    uint64_t vars; // distinct identifier codes
+    uint64_t aliases; // other vars sharing their identifier code
+    uint64_t scopes; // including unpacked arrays
+    uint64_t arrays;
+    double intervalSeconds; // total time constructing value intervals
+
+    /**
+     * @brief Get the CPU time used by all threads of the process so far.
+     *
+     * @return double seconds
+     */
+    static double cpuSeconds();
+
+   public:
+    /**
+     * @brief Construct a new LoadStats object with no phases.
+     */
+    LoadStats();
+
+    /**
+     * @brief Ends the phase in progress, if any, and starts a new one.
+     * Phases are also recorded as spans of the trace.
+     *
+     * @param name (const std::string&) name of the phase
+     */
+    void beginPhase(const std::string& name);
+
+    /**
+     * @brief Ends the phase in progress, if any.
+     */
+    void endPhase();
+
+    /**
+     * @brief Makes room for the work of `count` threads. Must be called
+     * before the threads record their work.
+     *
+     * @param count (size_t) number of threads
+     */
+    void reserveThreads(size_t count);
+
+    /**
+     * @brief Adds to the work of a thread. Each thread may only record its
+     * own slot, so threads record concurrently without locking.
+     *
+     * @param thread (size_t) slot of the thread, less than the count
+     * passed to `reserveThreads`
+     * @param vars (uint64_t) vars with new values
+     * @param changes (uint64_t) value changes processed
+     * @param seconds (double) time busy
+     */
+    void addThreadWork(size_t thread, uint64_t vars, uint64_t changes, double seconds);
+
+    /**
+     * @brief Get the total wall time of all phases.
+     *
+     * @return double seconds
+     */
+    double getWallSeconds();
+
+    /**
+     * @brief Get the peak resident set size of the process so far.
+     *
+     * @return uint64_t bytes
+     */
+    static uint64_t peakRssBytes();
+
+    /**
+     * @brief Get a summary for the startup screen.
+     *
+     * @return std::vector<std::string> lines of the summary
+     */
+    std::vector<std::string> summary();
+
+    /**
+     * @brief Get all statistics as a JSON object.
+     *
+     * @return std::string JSON text, ending with a newline
+     */
+    std::string toJson();
+
+    friend class Parser;
+};
+
+#endif
@@ -0,0 +1,131 @@
+/**
+ * Author:          Cynthia Wang
+ * Date created:    10/19/2026
+ * Organization:    ECE 4122
+ *
+ * Description:
+ * Header file for MemoryReport class, which accounts the memory used by
+ * each signal and scope of a parsed waveform.
+*/
+
+#ifndef __MEMORY_REPORT_HPP
+#define __MEMORY_REPORT_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "SignalIndex.hpp"
+#include "ValueTable.hpp"
+
+/**
+ * @brief Estimates of the memory used by each var and by each scope
+ * subtree, to find which signals are responsible for a large RSS, e.g. to
+ * exclude them from dumping.
+ */
+class MemoryReport
+{
+   public:
+    /**
+     * @brief Memory used by a var, or by all vars under a scope.
+     */
+    struct Usage
+    {
+        std::string path;    // full hierarchical name
+        uint64_t vars;       // 1 for a var
+        uint64_t changes;    // values stored
+        uint64_t valueBytes; // vars and their values
+        uint64_t indexBytes; // entries in the index of names
+
+        /**
+         * @brief Get the total bytes.
+         */
+        uint64_t getBytes() const
+        {
+            return valueBytes + indexBytes;
+        }
+    };
+
+   private:
+    /**
+     * @brief Memory counted for an entry of the index, before its path is
+     * looked up for one of the heaviest rows.
+     */
+    struct Counts
+    {
+        uint64_t vars;
+        uint64_t changes;
+        uint64_t valueBytes;
+        uint64_t indexBytes;
+    };
+
+    std::vector<Usage> vars;   // the heaviest, heaviest first
+    std::vector<Usage> scopes; // the heaviest, heaviest first, including unpacked arrays
+    Usage total;
+    uint64_t internedValues; // distinct values in the value table
+    uint64_t internedBytes;
+
+    /**
+     * @brief Formats a number of bytes with a unit, e.g. `12.3 MB`.
+     */
+    static std::string formatBytes(uint64_t bytes);
+
+    /**
+     * @brief Keeps the `count` heaviest of some entries as rows, heaviest
+     * first, building the paths of those rows only.
+     */
+    static void selectRows(SignalIndex& index, const std::vector<Counts>& counts, std::vector<SignalIndex::Id>& ids,
+        size_t count, std::vector<Usage>& rows);
+
+    /**
+     * @brief Formats rows as lines of a table, with the share of each row
+     * of `totalBytes`.
+     */
+    static void formatRows(const std::vector<Usage>& rows, uint64_t totalBytes, std::vector<std::string>& lines);
+
+   public:
+    /**
+     * @brief Accounts the memory of every var in an index, and of the
+     * values they share, keeping the heaviest vars and scopes. Values must
+     * not be published while this runs.
+     *
+     * @param index (SignalIndex&) index of the waveform
+     * @param values (ValueTable&) table of the interned values of the
+     * waveform, whose values are counted in the vars that added them and
+     * whose hash tables are counted in the total only
+     * @param count (size_t) number of vars and of scopes to keep
+     */
+    MemoryReport(SignalIndex& index, ValueTable& values, size_t count);
+
+    /**
+     * @brief Get the heaviest vars, heaviest first.
+     *
+     * @return const std::vector<Usage>& usage of at most `count` vars
+     */
+    const std::vector<Usage>& getVars();
+
+    /**
+     * @brief Get the heaviest scopes, including unpacked arrays, heaviest
+     * first.
+     *
+     * @return const std::vector<Usage>& usage of everything under at most
+     * `count` scopes
+     */
+    const std::vector<Usage>& getScopes();
+
+    /**
+     * @brief Get the total of all vars, including the interned values.
+     *
+     * @return const Usage& total usage
+     */
+    const Usage& getTotal();
+
+    /**
+     * @brief Formats the heaviest vars and scopes as lines of tables.
+     *
+     * @return std::vector<std::string> lines of the report
+     */
+    std::vector<std::string> format();
+};
+
+#endif
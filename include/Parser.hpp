@@ -10,18 +10,29 @@
 #ifndef __PARSER_HPP
 #define __PARSER_HPP
 
+#include <atomic>
 #include <map>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
 #include <string>
 #include <chrono>
+#include <future>
+#include <thread>
+#include <vector>
 
+#include "LoadStats.hpp"
+#include "SignalIndex.hpp"
+#include "ValueTable.hpp"
 #include "Vcd.hpp"
+#include "Waveform.hpp"
 
 /**
  * @brief Class for parsing VCD files into a traversable 
  * tree-like structure of `VcdNode`s that makes the signals
  * easier to process in Tabuwave.
  */
-class Parser 
+class Parser : public Waveform 
 {
    private:
     /**
@@ -54,10 +65,43 @@ class Parser
     size_t maxTime;
     std::vector<std::string> varHashes;
     std::map<std::string, VcdVar*> varMap;
+    std::vector<VcdVar*> aliases; // vars declared with the identifier code of a var in varMap
     std::list<VcdScope*> scopes; // to keep track for deleting and not double-deleting
-    std::map<std::string, VcdScope*> arrScopes;
+    std::vector<VcdArrScope*> arrScopes; // unpacked arrays, also in scopes
     std::chrono::high_resolution_clock::time_point startTime;
 
+    // progress of a parse that may be running on another thread
+    std::atomic<uint64_t> totalBytes;
+    std::atomic<uint64_t> bytesRead;
+    std::atomic<bool> definitionsDone;
+    std::atomic<bool> done;
+    std::atomic<uint64_t> frontier; // values up to this time are published
+    std::chrono::high_resolution_clock::time_point parseStartTime;
+    uint64_t intervalTime; // total us spent constructing value intervals
+    LoadStats stats;
+
+    // readers of published values hold this shared; publishing holds it exclusively
+    std::shared_mutex valuesMutex;
+
+    std::mutex reportMutex;
+    std::vector<std::string> report;
+
+    // value changes at currTime in file order, recorded as delta events if
+    // some var changes more than once at currTime
+    std::vector<VcdVar*> timeChanges;
+    bool timeHasDeltas;
+    std::map<uint64_t, std::vector<DeltaEvent>> deltaEvents; // guarded by valuesMutex
+
+    SignalIndex index;
+    ValueTable valueTable; // distinct values of the vars wider than 1 bit
+
+    // other files of a dump split into shards, parsed concurrently by
+    // their own parsers and merged into this one in time order
+    std::vector<std::unique_ptr<Parser>> shards;
+    std::vector<uint64_t> shardStartTimes; // first timestamp of each shard
+    std::vector<size_t> shardOrder; // shards sorted by first timestamp
+    bool publishing; // false for the parser of a shard, whose values are merged instead
+
     /**
      * @brief Get the parse state that the parser should transition to
      * after encountering the given token.
@@ -68,33 +112,106 @@ class Parser
     inline State getParseState(std::string token);
 
     /**
-     * @brief Constructs value intervals for all `VcdVar`s in under `top_scope`.
-     * startIdx and endIdx are used to distribute work when using std::thread.
+     * @brief Constructs value intervals from the pending value changes of
+     * all `VcdVar`s in under `top_scope`. startIdx and endIdx are used to
+     * distribute work over the threads of the `ThreadPool`.
      * 
-     * VCD files store data as value change records. This is parsed and stored 
-     * into interval trees to be able to quickly query the value at any time within 
-     * the simulation. `boost::icl::interval_map` is used for robustness.
+     * VCD files store data as value change records. These are stored as a
+     * compressed `TimeColumn` of change times per var to be able to quickly
+     * query the value at any time within the simulation, with the values of
+     * wider vectors interned in `valueTable`, which the threads share without
+     * a global lock. The latest change of each var is kept open-ended as its
+     * last value, since the time it ends is not known until more of the file
+     * is parsed.
      * 
      * @param startIdx (uint64_t) start index of var_hashes this call is 
      * responsible for.
      * @param endIdx (uint64_t) end index of var_hashes this call is 
      * responsible for.
+     * @param thread (size_t) slot of the calling thread in the stats
+     */
+    void constructValueIntervals(uint64_t startIdx, uint64_t endIdx, size_t thread);
+
+    /**
+     * @brief Parses `filename` into the tree of `VcdNode`s, publishing
+     * values progressively unless this is the parser of a shard.
+     */
+    void parseFile();
+
+    /**
+     * @brief Records the value changes at `currTime` as delta events, in
+     * the order of `timeChanges`. Must be called before the changes at
+     * `currTime` are published.
+     */
+    void recordDeltas();
+
+    /**
+     * @brief Orders the files of a split dump by their first timestamp,
+     * takes the first one to be parsed by this parser, and queues the
+     * parser of each of the others on the `ThreadPool`.
+     * 
+     * @param parsed (std::vector<std::future<void>>&) futures ready once
+     * each shard is parsed
+     */
+    void startShards(std::vector<std::future<void>>& parsed);
+
+    /**
+     * @brief Waits for the shards in time order and appends the value
+     * changes of each compatible shard to the vars of this parser, then
+     * publishes them. Shards whose header does not match or whose times
+     * overlap the previous shard are skipped and reported.
+     * 
+     * @param parsed (std::vector<std::future<void>>&) futures from
+     * `startShards`
+     */
+    void mergeShards(std::vector<std::future<void>>& parsed);
+
+    /**
+     * @brief Checks that a shard declares the same vars and timescale as
+     * this parser, so its value changes can be appended.
+     * 
+     * @param shard (Parser&) parser of the shard
+     * @return std::string reason the shard is incompatible, or an empty
+     * string if it is compatible
+     */
+    std::string checkShard(Parser& shard);
+
+    /**
+     * @brief Reads a VCD file up to its first timestamp.
+     * 
+     * @param filename (const std::string&) path to VCD file
+     * @return uint64_t first timestamp, or 0 if there is none
+     */
+    static uint64_t firstTimestamp(const std::string& filename);
+
+    /**
+     * @brief Finishes the header fields and marks the tree of `VcdNode`s
+     * as complete so it can be used while values are still being parsed.
+     * The signal index is built only if this parser publishes its values,
+     * not for a shard.
+     */
+    void finishDefinitions();
+
+    /**
+     * @brief Publishes all value changes parsed so far by constructing their
+     * value intervals, while holding `valuesMutex` exclusively, and advances
+     * the frontier.
+     * 
+     * @param newFrontier (uint64_t) time up to which all values are now known
      */
-    void constructValueIntervals(uint64_t startIdx, uint64_t endIdx);
+    void publishValues(uint64_t newFrontier);
 
-#ifdef USE_OMP
     /**
-     * @brief wrapper for constructValueIntervals(uint64_t startIdx, uint64_t endIdx)
-     * that passes in 0 as startIdx and var_hashes.size() as endIdx so that one
-     * call takes care of constructing value intervals for all `VcdVar`s.
+     * @brief Adds a line to the report shown on the startup screen.
+     * 
+     * @param line (std::string) line to add
      */
-    void constructValueIntervals();
-#endif
+    void addReport(std::string line);
 
     /**
      * @brief Starts measuring time.
      * 
-     * @param message (const char*) message to be printed in the window.
+     * @param message (const char*) message to be added to the report.
      */
     void startMeasureTime(const char* message);
 
@@ -102,7 +219,7 @@ class Parser
      * @brief Ends measuring time and reports the time in ms elapsed since
      * the last call to `startMeasureTime`.
      * 
-     * @param desc (const char*) description to be printed in the window
+     * @param desc (const char*) description to be added to the report
      * along with the total time in ms elapsed.
      */
     void endMeasureTime(const char* desc);
@@ -113,9 +230,18 @@ class Parser
      * 
      * @param filename (std::string) path to VCD file
      */
-    Parser(std::string filename)
-        : filename(filename), topScope(nullptr), currState(PARSE_NONE)
+    Parser(std::string filename) : Parser(std::vector<std::string>{filename})
         {};
+
+    /**
+     * @brief Construct a new Parser object for a dump split into several
+     * files with identical headers (e.g. `run.0.vcd`, `run.1.vcd`), which 
+     * are parsed concurrently and merged into one timeline.
+     * 
+     * @param filenames (std::vector<std::string>) paths to VCD files, in
+     * any order
+     */
+    Parser(std::vector<std::string> filenames);
     
     /**
      * @brief Destroy the Parser object and clean up dynamically 
@@ -124,10 +250,64 @@ class Parser
     ~Parser();
 
     /**
-     * @brief parse the VCD file into a tree-like structure of `VcdNode`s
+     * @brief parse the VCD file into a tree-like structure of `VcdNode`s.
+     * May be run on a background thread: the tree can be used once 
+     * `isDefinitionsDone` returns true, and values up to `getMaxTime` can be
+     * read while holding `getValuesMutex` shared.
      */
     void parse();
 
+    /**
+     * @brief Check if the definitions section has been parsed, i.e. the 
+     * tree of `VcdNode`s is complete.
+     * 
+     * @return true if the definitions are done
+     */
+    bool isDefinitionsDone();
+
+    /**
+     * @brief Check if the whole file has been parsed.
+     * 
+     * @return true if parsing is done
+     */
+    bool isDone();
+
+    /**
+     * @brief Get the number of bytes of the files parsed so far.
+     * 
+     * @return uint64_t bytes read
+     */
+    uint64_t getBytesRead();
+
+    /**
+     * @brief Get the total size of the files being parsed.
+     * 
+     * @return uint64_t total bytes
+     */
+    uint64_t getTotalBytes();
+
+    /**
+     * @brief Get the time elapsed since parsing started.
+     * 
+     * @return double seconds
+     */
+    double getParseSeconds();
+
+    /**
+     * @brief Get the lines of the report of parse times and file metadata.
+     * 
+     * @return std::vector<std::string> copy of the report
+     */
+    std::vector<std::string> getReport();
+
+    /**
+     * @brief Get the mutex guarding published values. Hold it shared
+     * while reading values of `VcdVar`s while parsing may be in progress.
+     * 
+     * @return std::shared_mutex& values mutex
+     */
+    std::shared_mutex& getValuesMutex();
+
     /**
      * @brief Get the top scope
      * 
@@ -135,6 +315,14 @@ class Parser
      */
     VcdScope* getTop();
 
+    /**
+     * @brief Get the index over the full hierarchical names of all nodes.
+     * Valid once `isDefinitionsDone` returns true.
+     * 
+     * @return SignalIndex& index
+     */
+    SignalIndex& getIndex();
+
     /**
      * @brief Get the VcdVar from the given `hierarchicalName` starting from
      * `scope`.
@@ -142,22 +330,39 @@ class Parser
      * @param hierarchicalName (std::string) full hierarchical name of the 
      * signal starting from the name of `scope`.
      * @param scope (VcdScope*) pointer of VcdScope object to look under.
-     * @return pointer to VcdVar object.
+     * @return pointer to VcdVar object, or nullptr if there is none.
      */
     VcdVar* getVcdVar(std::string hierarchicalName, VcdScope* scope);
 
     /**
      * @brief Get the VcdVar from the given `hierarchicalName` starting at
-     * the top scope.
+     * the top scope, with a hashed lookup of the full name in the index.
      * 
      * @param hierarchicalName (std::string) full hierarchical name of the 
      * signal starting from the name of top scope
-     * @return pointer to VcdVar object. 
+     * @return pointer to VcdVar object, or nullptr if there is none. 
      */
     VcdVar* getVcdVar(std::string hierarchicalName);
 
     /**
-     * @brief Get the end time of the simulation
+     * @brief Get the statistics of loading the waveform, which are complete
+     * once `isDone` returns true.
+     * 
+     * @return LoadStats& stats
+     */
+    LoadStats& getStats();
+
+    /**
+     * @brief Get the table of the distinct values of the vars wider than 1
+     * bit, shared by all of them.
+     * 
+     * @return ValueTable& value table
+     */
+    ValueTable& getValueTable();
+
+    /**
+     * @brief Get the end time of the simulation, or the latest time whose
+     * values are published if parsing is still in progress.
      * 
      * @return size_t end time
      */
@@ -169,6 +374,24 @@ class Parser
      * @return std::string timescale
      */
     std::string getTimescale();
+
+    /**
+     * @brief Get every value change at `time`, in file order, if some var
+     * changes more than once at `time`.
+     * 
+     * @param time (uint64_t) time to get the events of
+     * @return std::vector<DeltaEvent> events, or empty if `time` has no
+     * delta cycles
+     */
+    std::vector<DeltaEvent> getDeltaEvents(uint64_t time);
+
+    /**
+     * @brief Get the first time after `time` with delta cycles.
+     * 
+     * @param time (uint64_t) time to search after
+     * @return uint64_t next time with delta cycles, or UINT64_MAX if none
+     */
+    uint64_t getNextDeltaTime(uint64_t time);
 };
 
 #endif
\ No newline at end of file
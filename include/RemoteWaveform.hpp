@@ -0,0 +1,175 @@
+/**
+ * Author:          Cynthia Wang
+ * Date created:    10/19/2026
+ * Organization:    ECE 4122
+ *
+ * Description:
+ * Header file for RemoteWaveform class, a client of a tabuwave server that
+ * provides the waveform the server holds to the TUI.
+*/
+
+#ifndef __REMOTE_WAVEFORM_HPP
+#define __REMOTE_WAVEFORM_HPP
+
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <vector>
+
+#include "SignalIndex.hpp"
+#include "Vcd.hpp"
+#include "Waveform.hpp"
+
+class RemoteWaveform;
+
+/**
+ * @brief A var whose values are held by a server. Its values are requested
+ * when read, so every accessor of `VcdVar` works on it.
+ */
+class RemoteVar : public VcdVar
+{
+   private:
+    RemoteWaveform* remote;
+    SignalIndex::Id id; // id of the var on the server
+
+    /**
+     * @brief Requests the value at the specified time from the server.
+     */
+    const std::string valueAt(uint64_t time);
+
+   public:
+    RemoteVar(RemoteWaveform* remote, SignalIndex::Id id) : VcdNode(VAR), remote(remote), id(id)
+    {}
+
+    uint64_t getNextChange(uint64_t time);
+
+    void forEachValue(uint64_t endTime, const std::function<void(uint64_t, uint64_t, const std::string&)>& fn);
+};
+
+/**
+ * @brief An unpacked array whose elements are `RemoteVar`s, which finds
+ * the next change of all its elements with one request.
+ */
+class RemoteArrScope : public VcdArrScope
+{
+   private:
+    RemoteWaveform* remote;
+    SignalIndex::Id id; // id of the array on the server
+
+   public:
+    RemoteArrScope(RemoteWaveform* remote, SignalIndex::Id id) : VcdNode(ARR_SCOPE), remote(remote), id(id)
+    {}
+
+    uint64_t getNextChange(uint64_t time);
+};
+
+/**
+ * @brief Waveform held by a server started with `--serve`, read over its
+ * Unix domain socket. The tree of nodes is copied once the server has
+ * parsed the definitions, and values are requested as they are read, so
+ * the client holds no values. Requests from several threads share the
+ * connection one at a time. See `Server` for the protocol.
+ */
+class RemoteWaveform : public Waveform
+{
+   private:
+    int fd;
+    std::mutex connectionMutex;
+    std::string buffer; // received but not yet read
+
+    VcdScope* topScope;
+    std::vector<VcdNode*> nodes; // copied tree, by id on the server
+    SignalIndex index;
+    std::shared_mutex valuesMutex; // the server guards its values, so never held exclusively
+
+    // progress of the server, refreshed at most every INFO_INTERVAL while it parses
+    bool definitionsDone;
+    bool done;
+    uint64_t maxTime;
+    uint64_t bytesRead;
+    uint64_t totalBytes;
+    double parseSeconds;
+    std::string timescale;
+    std::chrono::steady_clock::time_point lastInfo;
+    static constexpr int INFO_INTERVAL_MS = 50;
+
+    /**
+     * @brief Reads a line from the connection. The connection must be locked.
+     *
+     * @return false if the connection is closed
+     */
+    bool readLine(std::string& line);
+
+    /**
+     * @brief Refreshes the progress of the server.
+     */
+    void updateInfo();
+
+    /**
+     * @brief Copies the tree of nodes from the server and indexes it.
+     */
+    bool buildTree();
+
+   public:
+    /**
+     * @brief Construct a new RemoteWaveform object that is not connected.
+     */
+    RemoteWaveform();
+
+    /**
+     * @brief Destroy the RemoteWaveform object, closing the connection and
+     * deleting the copied tree.
+     */
+    ~RemoteWaveform();
+
+    /**
+     * @brief Connects to a server.
+     *
+     * @param path (const std::string&) path of the server's socket
+     * @param error (std::string&) set to the reason on error
+     * @return true on success, false on error
+     */
+    bool connect(const std::string& path, std::string& error);
+
+    /**
+     * @brief Sends a request and reads the response.
+     *
+     * @param request (const std::string&) request, without the newline
+     * @param fields (std::vector<std::string>&) set to the fields of the
+     * first line of the response after `OK`
+     * @param lines (std::vector<std::string>*) if not null, set to the lines
+     * following the first, whose count is its last field
+     * @return true on an `OK` response, false on an error or a closed connection
+     */
+    bool request(const std::string& request, std::vector<std::string>& fields, std::vector<std::string>* lines = nullptr);
+
+    bool isDefinitionsDone();
+
+    bool isDone();
+
+    uint64_t getBytesRead();
+
+    uint64_t getTotalBytes();
+
+    double getParseSeconds();
+
+    std::vector<std::string> getReport();
+
+    std::shared_mutex& getValuesMutex();
+
+    VcdScope* getTop();
+
+    SignalIndex& getIndex();
+
+    size_t getMaxTime();
+
+    std::string getTimescale();
+
+    std::vector<DeltaEvent> getDeltaEvents(uint64_t time);
+
+    uint64_t getNextDeltaTime(uint64_t time);
+};
+
+#endif
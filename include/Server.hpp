@@ -0,0 +1,159 @@
+/**
+ * Author:          Cynthia Wang
+ * Date created:    10/19/2026
+ * Organization:    ECE 4122
+ *
+ * Description:
+ * Header file for Server class, which answers queries about one parsed
+ * waveform over a Unix domain socket.
+*/
+
+#ifndef __SERVER_HPP
+#define __SERVER_HPP
+
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "Vcd.hpp"
+#include "Waveform.hpp"
+
+/**
+ * @brief Serves one waveform, parsed once, to several clients over a Unix
+ * domain socket. One thread polls up to `MAX_CONNECTIONS` connections for
+ * requests and a pool of `numThreads` workers answers them, each reading
+ * values while holding the values mutex shared, so a client that stays
+ * connected holds no thread between requests and clients are answered
+ * concurrently while parsing continues in the background. A connection has
+ * one request answered at a time, in order.
+ *
+ * The protocol is line-based with tab-separated fields. Each request is
+ * one line, and each response is one line starting with `OK` or with
+ * `ERR` and a message; a response ending with a count is followed by that
+ * many lines. A request longer than `MAX_REQUEST_BYTES` closes the
+ * connection. Nodes are identified by their id in the `SignalIndex`, and
+ * times are in units of the timescale.
+ *
+ *     INFO                    OK defsDone done maxTime bytesRead totalBytes parseSeconds timescale
+ *     REPORT                  OK n, then the lines of the parse report
+ *     TREE                    OK n, then a line per node in id order:
+ *                                 parent kind(S|A|V|R|T) size element name
+ *                             with R and T for real and string vars and
+ *                             a parent of -1 for the top scope and an
+ *                             element of -1 for nodes other than array elements
+ *     VALUE id time           OK value, as stored in the VCD file
+ *     NEXT id time            OK time of the next change after time, or none
+ *     CHANGES id start end    OK next n, then start, end (exclusive) and
+ *                             value of each value of a var from the one
+ *                             held at start up to end, at most MAX_CHANGES;
+ *                             next is the start to request the rest from,
+ *                             or none
+ *     DELTAS time             OK n, then id, value and previous value of
+ *                             each change at time in file order, if some
+ *                             var changes more than once at time
+ *     NEXTDELTA time          OK next time with delta cycles after time, or none
+ *     SEARCH limit query      OK n, then id and path of the best matches
+ *     QUERY <batch query>     OK n, then the lines --batch prints for a query,
+ *                             once parsing is done
+ */
+class Server
+{
+   private:
+    static constexpr size_t MAX_CONNECTIONS = 256;
+    static constexpr size_t MAX_REQUEST_BYTES = 1 << 20;
+    static constexpr size_t MAX_CHANGES = 1 << 16;
+
+    Waveform* parser;
+    size_t numThreads;
+    int listener;
+    int wake[2]; // pipe waking the polling thread when a request is answered
+
+    /**
+     * @brief A connection, used by the polling thread only.
+     */
+    struct Connection
+    {
+        std::string buffer; // received, not yet answered
+        bool busy;          // a worker is answering a request
+    };
+    std::map<int, Connection> connections; // by socket
+
+    // requests waiting for a worker, and the sockets whose request was
+    // answered, with whether the response was sent
+    std::mutex queueMutex;
+    std::condition_variable queueCondition;
+    std::deque<std::pair<int, std::string>> requests;
+    std::vector<std::pair<int, bool>> answered;
+
+    // tree, built once the definitions are done
+    std::mutex treeMutex;
+    std::string tree;
+
+    // the index keeps the last search to narrow the next one
+    std::mutex searchMutex;
+
+    /**
+     * @brief Answers requests from the queue, sending each response.
+     */
+    void work();
+
+    /**
+     * @brief Queues the next request received on a connection that is not
+     * waiting for a response.
+     *
+     * @return false if the connection sent too long a request and is closed
+     */
+    bool dispatch(int fd, Connection& connection);
+
+    /**
+     * @brief Closes a connection.
+     */
+    void disconnect(int fd);
+
+    /**
+     * @brief Answers one request.
+     *
+     * @return std::string response, ending with a newline
+     */
+    std::string handle(const std::string& request);
+
+    /**
+     * @brief Get the TREE response, building it if needed.
+     */
+    const std::string& getTree();
+
+   public:
+    /**
+     * @brief Construct a new Server object.
+     *
+     * @param parser (Waveform*) waveform to serve, which may still be parsing
+     * @param numThreads (size_t) number of requests answered at once
+     */
+    Server(Waveform* parser, size_t numThreads) : parser(parser), numThreads(numThreads), listener(-1), wake{-1, -1}
+    {}
+
+    ~Server();
+
+    /**
+     * @brief Creates a Unix domain socket and listens on it. A socket left
+     * at the path by an earlier server is replaced, but any other file is not.
+     *
+     * @param path (const std::string&) path of the socket
+     * @param error (std::string&) set to the reason if the socket could not
+     * be created
+     * @return false if the socket could not be created
+     */
+    bool listen(const std::string& path, std::string& error);
+
+    /**
+     * @brief Serves connections to the socket created by `listen` until the
+     * process is stopped. While `MAX_CONNECTIONS` are open, or no more files
+     * can be opened, new connections wait to be accepted.
+     */
+    void run();
+};
+
+#endif
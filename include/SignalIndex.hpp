@@ -0,0 +1,151 @@
+/**
+ * Author:          Cynthia Wang
+ * Date created:    10/19/2026
+ * Organization:    ECE 4122
+ *
+ * Description:
+ * Header file for SignalIndex class, an index over the full hierarchical
+ * names of all parsed nodes for hashed lookups and ranked searches.
+*/
+
+#ifndef __SIGNAL_INDEX_HPP
+#define __SIGNAL_INDEX_HPP
+
+#include <atomic>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Vcd.hpp"
+
+/**
+ * @brief Index over the full hierarchical names (e.g. `TOP.scoreboard.clk`)
+ * of every node under the top scope. Provides a hashed lookup from a full
+ * name to its node, and a search returning nodes ranked by how well their
+ * names match a query, backed by trigrams of the node names.
+ */
+class SignalIndex
+{
+   public:
+    /**
+     * @brief Id of an entry in the index.
+     */
+    typedef uint32_t Id;
+    static const Id NONE = (Id)-1;
+
+   private:
+    /**
+     * @brief Data structure for an indexed node.
+     */
+    struct Entry
+    {
+        VcdNode* node;
+        Id parent;          // entry of the scope containing the node
+        uint32_t nameStart; // offset of the node's own name in path
+        std::string path;   // full hierarchical name
+    };
+
+    std::vector<Entry> entries;
+    std::unordered_map<std::string, Id> pathMap;
+    std::unordered_map<VcdNode*, Id> nodeMap; // first entry of each node
+    std::unordered_map<uint32_t, std::vector<Id>> trigrams; // trigram of names -> entries
+    std::atomic<bool> trigramsReady;
+
+    // last search, so a query that extends it only filters its matches
+    std::string lastQuery;
+    std::vector<Id> lastMatches;
+
+    /**
+     * @brief Adds `node` and everything under it to the entries.
+     */
+    void addEntries(VcdNode* node, Id parent, const std::string& prefix);
+
+    /**
+     * @brief Scores how well `entry` matches a query, where the last term
+     * must be a substring of the entry's own name and the other terms must
+     * appear in order in the path of its scope.
+     *
+     * @return int score, higher is better, or -1 if it does not match
+     */
+    static int score(const Entry& entry, const std::vector<std::string>& terms);
+
+   public:
+    /**
+     * @brief Construct a new empty SignalIndex object
+     */
+    SignalIndex() : trigramsReady(false)
+    {}
+
+    /**
+     * @brief Indexes the full names of all nodes under `top` for lookups.
+     *
+     * @param top (VcdScope*) top scope
+     */
+    void build(VcdScope* top);
+
+    /**
+     * @brief Builds the trigram index used by `search`. Until this is done,
+     * `search` scans all names instead. May run on another thread than
+     * `search`.
+     */
+    void buildTrigrams();
+
+    /**
+     * @brief Get the node with the given full hierarchical name.
+     *
+     * @param path (const std::string&) full hierarchical name
+     * @return VcdNode* node, or nullptr if there is none
+     */
+    VcdNode* find(const std::string& path);
+
+    /**
+     * @brief Get the entry of a node, so its full hierarchical name can be
+     * retrieved.
+     *
+     * @param node (VcdNode*) node under the top scope
+     * @return Id entry of the node, or NONE if it is not indexed
+     */
+    Id getId(VcdNode* node);
+
+    /**
+     * @brief Search for nodes matching `query`, ranked best first. Terms
+     * of the query are separated by spaces or dots; the last term must be
+     * part of a node's name, and the others must appear in order in the
+     * names of the scopes containing it.
+     *
+     * @param query (const std::string&) case-insensitive query
+     * @param limit (size_t) maximum number of results
+     * @param total (size_t*) if not null, set to the total number of matches
+     * @return std::vector<Id> ids of the best matches
+     */
+    std::vector<Id> search(const std::string& query, size_t limit, size_t* total = nullptr);
+
+    /**
+     * @brief Get the node of an entry.
+     */
+    VcdNode* getNode(Id id);
+
+    /**
+     * @brief Get the entry of the scope containing an entry's node, or NONE
+     * for the top scope.
+     */
+    Id getParent(Id id);
+
+    /**
+     * @brief Get the full hierarchical name of an entry.
+     */
+    const std::string& getPath(Id id);
+
+    /**
+     * @brief Get the number of entries.
+     */
+    size_t size();
+
+    /**
+     * @brief Estimate the bytes of memory the index uses for an entry: the
+     * entry, its path, its hash table nodes and its trigram postings.
+     */
+    size_t getEntryBytes(Id id);
+};
+
+#endif
@@ -0,0 +1,114 @@
+/**
+ * Author:          Cynthia Wang
+ * Date created:    10/19/2026
+ * Organization:    ECE 4122
+ *
+ * Description:
+ * Header file for ThreadPool class, the pool of worker threads shared by
+ * every parallel stage of parsing, analysis and the TUI.
+*/
+
+#ifndef __THREAD_POOL_HPP
+#define __THREAD_POOL_HPP
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Process-wide pool of worker threads. The number of threads is set
+ * once, with `-j` or from the cores the process may run on, and caps the
+ * threads doing work at once: a parallel loop runs on the workers and on
+ * the calling thread, so a pool of N threads has N - 1 workers, and a pool
+ * of 1 thread runs everything on the calling thread.
+ */
+class ThreadPool
+{
+   private:
+    std::vector<std::thread> workers;
+    std::deque<std::function<void()>> tasks;
+    std::mutex mutex;
+    std::condition_variable taskAvailable;
+
+    static size_t configuredThreads; // 0 for the default
+
+    /**
+     * @brief Construct a new ThreadPool object and start its workers.
+     *
+     * @param numThreads (size_t) number of threads, including the caller
+     * of parallel loops
+     */
+    ThreadPool(size_t numThreads);
+
+    /**
+     * @brief Loop run by each worker, running queued tasks forever.
+     */
+    void workerLoop();
+
+   public:
+    /**
+     * @brief Get the number of cores the process may run on: the hardware
+     * threads, limited by the CPU affinity mask and by the CPU quota of its
+     * cgroup on Linux.
+     *
+     * @return size_t number of cores, at least 1
+     */
+    static size_t defaultThreads();
+
+    /**
+     * @brief Sets the number of threads of the pool. Has no effect once the
+     * pool is created by the first call to `get`.
+     *
+     * @param numThreads (size_t) number of threads, or 0 for the default
+     */
+    static void setThreads(size_t numThreads);
+
+    /**
+     * @brief Get the pool, creating it on first use. The pool lives until
+     * the program exits, which does not wait for tasks in progress.
+     *
+     * @return ThreadPool& the pool
+     */
+    static ThreadPool& get();
+
+    /**
+     * @brief Get the number of threads of the pool, including the caller of
+     * parallel loops.
+     *
+     * @return size_t number of threads, at least 1
+     */
+    size_t getThreads();
+
+    /**
+     * @brief Get the number of worker threads, which run submitted tasks.
+     *
+     * @return size_t number of workers, 0 if the pool has 1 thread
+     */
+    size_t getWorkers();
+
+    /**
+     * @brief Queues a task to run on a worker. Runs it on the calling
+     * thread if there are no workers.
+     *
+     * @param task (std::function<void()>) task to run
+     */
+    void submit(std::function<void()> task);
+
+    /**
+     * @brief Runs `fn` for each index in [0, count) on the workers and on
+     * the calling thread, and returns once all have run. Indices are handed
+     * out one at a time, so a worker busy with other tasks never delays the
+     * loop, and loops may be nested in tasks.
+     *
+     * @param count (size_t) number of indices
+     * @param fn (const std::function<void(size_t, size_t)>&) function taking
+     * the index and a slot in [0, getThreads()) unique to the thread
+     * running it within this loop, e.g. for per-thread results
+     */
+    void parallelFor(size_t count, const std::function<void(size_t, size_t)>& fn);
+};
+
+#endif
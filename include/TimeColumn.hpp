@@ -0,0 +1,124 @@
+/**
+ * Author:          Cynthia Wang
+ * Date created:    10/19/2026
+ * Organization:    ECE 4122
+ *
+ * Description:
+ * Header file for TimeColumn class, a compressed column of increasing
+ * change times.
+*/
+
+#ifndef __TIME_COLUMN_HPP
+#define __TIME_COLUMN_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+/**
+ * @brief Column of strictly increasing times, stored as the differences
+ * between consecutive times encoded as varints (7 bits per byte), so the
+ * small regular steps of clocks and valids take a byte or two each instead
+ * of eight. The column is split into blocks of `BLOCK_SIZE` times, and a
+ * skip index holds the first time of each block and where its differences
+ * start, so a lookup is a binary search over the blocks followed by
+ * decoding at most one block.
+ */
+class TimeColumn
+{
+   private:
+    static constexpr size_t BLOCK_SIZE = 64;
+
+    /**
+     * @brief Entry of the skip index for a block of times.
+     */
+    struct Block
+    {
+        uint64_t firstTime;
+        size_t offset; // position in `deltas` of the difference to the second time
+    };
+
+    std::vector<Block> blocks;
+    std::vector<uint8_t> deltas;
+    size_t count;
+    uint64_t lastTime;
+
+    /**
+     * @brief Decodes the times of a block from its first.
+     *
+     * @param block (size_t) index of the block
+     * @param fn (const std::function<bool(size_t, uint64_t)>&) called with
+     * the position and time of each time in order; decoding stops when it
+     * returns false
+     * @return false if `fn` stopped decoding
+     */
+    bool decodeBlock(size_t block, const std::function<bool(size_t, uint64_t)>& fn);
+
+   public:
+    TimeColumn() : count(0), lastTime(0)
+    {}
+
+    /**
+     * @brief Appends a time, which must be greater than the last time.
+     *
+     * @param time (uint64_t) time to append
+     */
+    void push_back(uint64_t time);
+
+    /**
+     * @brief Get the number of times.
+     *
+     * @return size_t number of times
+     */
+    size_t size();
+
+    /**
+     * @brief Check if the column has no times.
+     *
+     * @return true if there are no times
+     */
+    bool empty();
+
+    /**
+     * @brief Get the last time. The column must not be empty.
+     *
+     * @return uint64_t last time
+     */
+    uint64_t back();
+
+    /**
+     * @brief Get the time at a position.
+     *
+     * @param pos (size_t) position, less than `size()`
+     * @return uint64_t time
+     */
+    uint64_t at(size_t pos);
+
+    /**
+     * @brief Get the position of the first time after `time`.
+     *
+     * @param time (uint64_t) time to search for
+     * @return size_t position, or `size()` if every time is at most `time`
+     */
+    size_t upperBound(uint64_t time);
+
+    /**
+     * @brief Decodes every time in order from a position.
+     *
+     * @param fn (const std::function<bool(size_t, uint64_t)>&) called with
+     * the position and time of each time; decoding stops when it returns
+     * false
+     * @param from (size_t) position of the first time to decode
+     */
+    void forEach(const std::function<bool(size_t, uint64_t)>& fn, size_t from = 0);
+
+    /**
+     * @brief Get an estimate of the bytes the column allocates.
+     *
+     * @return size_t bytes, not counting the object itself
+     */
+    size_t getMemoryBytes();
+};
+
+#endif
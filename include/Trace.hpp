@@ -0,0 +1,98 @@
+/**
+ * Author:          Cynthia Wang
+ * Date created:    10/19/2026
+ * Organization:    ECE 4122
+ *
+ * Description:
+ * Header file for Trace class, which records a timeline of spans of work
+ * on each thread as a Chrome trace.
+*/
+
+#ifndef __TRACE_HPP
+#define __TRACE_HPP
+
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief Opt-in recorder of spans of work, e.g. parser phases, value
+ * interval construction on each thread and TUI frames, written as Chrome
+ * trace event JSON (viewable in chrome://tracing or Perfetto) when the
+ * program exits. Recording does nothing until `start` is called, so spans
+ * can be left in hot paths.
+ */
+class Trace
+{
+   public:
+    /**
+     * @brief A span of work on the calling thread, from construction until
+     * `end` is called or it is destroyed.
+     */
+    class Span
+    {
+       private:
+        const char* name;
+        const char* category;
+        double startUs;
+        bool open;
+
+       public:
+        /**
+         * @brief Starts a span if tracing is enabled.
+         *
+         * @param name (const char*) name of the span, which must outlive it
+         * @param category (const char*) category of the span, e.g. `parse` or `ui`
+         */
+        Span(const char* name, const char* category);
+
+        /**
+         * @brief Ends the span if it has not been ended.
+         */
+        ~Span();
+
+        /**
+         * @brief Ends the span early, e.g. before the next span of a sequence.
+         */
+        void end();
+    };
+
+    /**
+     * @brief Enables tracing, to be written to a file at exit.
+     *
+     * @param path (const std::string&) file to write the trace to
+     */
+    static void start(const std::string& path);
+
+    /**
+     * @brief Check if tracing is enabled.
+     *
+     * @return true if spans are recorded
+     */
+    static bool isEnabled();
+
+    /**
+     * @brief Get the time since tracing started.
+     *
+     * @return double microseconds
+     */
+    static double now();
+
+    /**
+     * @brief Records a span of work on the calling thread that has already
+     * ended, if tracing is enabled.
+     *
+     * @param name (const std::string&) name of the span
+     * @param category (const char*) category of the span
+     * @param startUs (double) time the span started, from `now`
+     * @param durationUs (double) duration of the span in microseconds
+     */
+    static void complete(const std::string& name, const char* category, double startUs, double durationUs);
+
+    /**
+     * @brief Writes the trace recorded so far. Called at exit once tracing
+     * is started.
+     */
+    static void write();
+};
+
+#endif
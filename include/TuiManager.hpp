@@ -13,17 +13,30 @@
 #include <ncurses.h>
 
 #include <list>
+#include <map>
+#include <set>
 #include <string>
+#include <unordered_set>
+#include <vector>
 
+#include "ActivityStats.hpp"
+#include "DerivedColumn.hpp"
+#include "Exporter.hpp"
+#include "FrameCache.hpp"
+#include "LifetimeTracker.hpp"
+#include "Parser.hpp"
 #include "Vcd.hpp"
+#include "WaveformDiff.hpp"
 
 #define COLOR_INFO 1
 #define COLOR_BOLD 2
 #define COLOR_ERROR 3
+#define COLOR_DIFF 4
 #define DISPLAY_INFO COLOR_PAIR(COLOR_INFO) | A_STANDOUT
 #define DISPLAY_BOLD COLOR_PAIR(COLOR_BOLD) | A_BOLD
 #define DISPLAY_ERROR COLOR_PAIR(COLOR_ERROR) | A_BOLD
 #define DISPLAY_SELECTED A_STANDOUT
+#define DISPLAY_DIFF COLOR_PAIR(COLOR_DIFF) | A_BOLD
 
 /**
  * @brief A wrapper class for `ncurses` functions and keeps state for 
@@ -38,62 +51,315 @@ class TuiManager
     size_t timescaleMultiplier;
     std::string timescaleUnit;
 
+    Waveform* parser;
+
+    /**
+     * @brief Position of a row in the menu, as the path of child iterators
+     * from the top scope down to the row's node (empty for the top scope).
+     * Rows are never materialized; positions move through the tree directly,
+     * so moving to the next or previous row does not depend on how many 
+     * children a scope has.
+     */
+    typedef std::vector<std::map<std::string, VcdNode*>::const_iterator> MenuPos;
+
     /**
-     * @brief Data structure for an item in the menu.
+     * @brief Data structure for a formatted cell of the table or a 
+     * formatted line of the menu.
      */
-    struct MenuItem 
+    struct Cell 
     {
-        VcdNode* node;
-        bool expanded;
-        int level;
-        std::list<MenuItem>::iterator lastChild;  // only valid if expanded
-        MenuItem(VcdNode* node, int level)
-            : node(node), expanded(false), level(level){};
+        std::string text;
+        attr_t attr;
+        bool operator==(const Cell& other) const 
+        {
+            return text == other.text && attr == other.attr;
+        }
     };
+
+    /**
+     * @brief Data structure for the last formatted table frame. The key
+     * identifies the state the frame was built from, so an unchanged frame
+     * is not rebuilt, and the layout decides whether the frame on screen
+     * can be patched cell by cell.
+     */
+    struct TableFrame 
+    {
+        bool valid;
+        // key
+        uint64_t timestamp;
+        uint64_t selectionVersion;
+        uint64_t queryVersion;
+        uint64_t highlightIdx;
+        size_t deltaStep;
+        // layout
+        size_t rowOffset;
+        size_t colOffset;
+        size_t numRows;
+        size_t height;
+        size_t width;
+        bool lined;
+        std::vector<size_t> colWidths;
+        std::vector<std::vector<Cell>> cells; // [row][0] is the index column
+        TableFrame() : valid(false) {};
+    };
+
     // for menu
-    std::list<MenuItem> visibleMenuItems;
-    std::list<MenuItem>::iterator cursorPos;
+    VcdScope* menuTop;
+    std::unordered_set<VcdNode*> expanded; // expanded scopes
+    MenuPos cursorPos;
     std::map<std::string, VcdPrimitive*> selected;
+    uint64_t selectionVersion; // incremented whenever selected changes
     size_t maxSelectedSize;
     uint64_t maxTime;
+    WINDOW* menuPad;
+    std::vector<Cell> menuLines; // lines currently in menuPad
 
     // for table
     uint64_t timestamp;
     bool lined;
     uint64_t highlightIdx;
+    size_t rowOffset;   // first index shown in the viewport
+    size_t colOffset;   // first selected signal shown in the viewport
     std::map<std::string, std::set<std::string>> query;
+    uint64_t queryVersion; // incremented whenever query changes
+    WINDOW* tablePad;
+    TableFrame frame;
+    FrameCache frameCache;
+    int stepDirection; // direction of the last time step, for prefetching
+
+    // for stepping through the delta cycles of a timestamp
+    static constexpr size_t NO_DELTA_STEP = (size_t)-1; // table shows the final values
+    std::vector<DeltaEvent> deltaEvents; // events at deltaTime
+    uint64_t deltaTime;
+    size_t deltaStep; // number of events of deltaTime applied, or NO_DELTA_STEP
+
+    // whether a parser was running at the last getInput, i.e. the screen
+    // drawn since may still show it running
+    bool parsingAtLastInput;
+
+    // derived columns by name; every column defined is kept until exit
+    // since prefetch workers may still be decoding a replaced one
+    std::map<std::string, DerivedColumn*> derived;
+    std::vector<std::unique_ptr<DerivedColumn>> derivedColumns;
+
+    // for diff mode
+    Parser* diffParser;
+    std::map<std::string, VcdPrimitive*> diffSelected; // matching signals of the second waveform
+    uint64_t diffSelectionVersion; // selectionVersion diffSelected was matched for
+    size_t diffUnmatched; // selected signals with no matching signal
+    std::string diffError; // why the waveforms cannot be compared, if they cannot
+    WaveformDiff waveformDiff;
+    FrameCache diffFrameCache;
+
+    /**
+     * @brief Makes sure `pad` exists with the given dimensions, creating
+     * it or resizing it only when needed so pads are reused across frames.
+     * 
+     * @param pad (WINDOW*&) pad to create or resize
+     * @param rows (size_t) number of rows needed
+     * @param cols (size_t) number of columns needed
+     */
+    void ensurePad(WINDOW*& pad, size_t rows, size_t cols);
 
     /**
-     * @brief Creates a scrollable pad for the table, sets it up and 
-     * fills its buffer with text based on timestamp, selected signals,
-     * and other state info, then displays it in the window.
+     * @brief Formats the visible part of the table based on timestamp,
+     * selected signals, and other state info into the persistent table
+     * pad, then displays it in the window. Only the rows and columns inside
+     * the viewport are retrieved and formatted; if the state is unchanged
+     * since the last frame nothing is redrawn, and if the layout is
+     * unchanged only cells whose contents changed are rewritten.
      */
     void printTable();
 
     /**
-     * @brief Creates a scrollable pad for the menu, sets it up and 
-     * fills its buffer with text based on visibleMenuItems, selected 
-     * signals, and other state info, then displays it in the window.
+     * @brief Replaces the values of the vars changed at `deltaTime` in a
+     * frame with their values after the first `deltaStep` delta events.
+     * 
+     * @param values (FrameCache::Frame&) frame of the final values
+     * @param columns (const FrameCache::Columns&) columns of the frame
+     * @param start (size_t) first index of the frame
+     * @param count (size_t) number of indices of the frame
+     */
+    void applyDeltaStep(FrameCache::Frame& values, const FrameCache::Columns& columns, size_t start, size_t count);
+
+    /**
+     * @brief Loads the delta events at the current timestamp and starts
+     * stepping through them with all of them applied.
+     * 
+     * @return true if the timestamp has delta cycles
+     */
+    bool startDeltaSteps();
+
+    /**
+     * @brief Describes the delta event last applied, for the bottom line.
+     * 
+     * @return std::string description
+     */
+    std::string deltaStepString();
+
+    /**
+     * @brief Matches the selected signals to the signals of the second
+     * waveform with the same hierarchical names, once its definitions are
+     * parsed and whenever the selection changes. Nothing is matched if the
+     * timescales of the waveforms differ, since their times would not
+     * correspond.
+     */
+    void matchDiffSignals();
+
+    /**
+     * @brief Updates height and width after the terminal has been resized.
+     */
+    void resize();
+
+    /**
+     * @brief Waits for a key press. While the parser is still running, and
+     * once more after it finishes so the final state gets drawn, this returns
+     * ERR periodically so the progress shown can be updated.
+     * 
+     * @return int key pressed, or ERR if none was pressed in time
+     */
+    int getInput();
+
+    /**
+     * @brief Formats the progress of the parser as a progress bar with the
+     * bytes parsed, throughput and estimated time remaining.
+     * 
+     * @return std::string progress, or an empty string if parsing is done
+     */
+    std::string progressString();
+
+    /**
+     * @brief Formats the rows of the menu inside the viewport, centered on
+     * the cursor, based on the expanded scopes, selected signals, and other
+     * state info into the persistent menu pad, rewriting only lines that
+     * changed, then displays it in the window.
      */
     void printMenu();
 
     /**
-     * @brief Expands a scope menu item. All direct children of 
-     * scope will be added to visibleMenuItems.
+     * @brief Writes lines into the persistent menu pad, rewriting only
+     * lines that changed since the last call, then displays it in the
+     * window.
+     * 
+     * @param lines (std::vector<Cell>&) lines to display; padded to the
+     * height of the menu
+     */
+    void printMenuLines(std::vector<Cell>& lines);
+
+    /**
+     * @brief Display a search prompt in place of the menu, showing the 
+     * signals matching the query ranked best first as it is typed, and 
+     * move the menu cursor to the chosen match.
+     */
+    void displaySearch();
+
+    /**
+     * @brief Moves the menu cursor to an entry of the signal index,
+     * expanding the scopes containing it.
+     * 
+     * @param id (SignalIndex::Id) entry to move to
+     */
+    void reveal(SignalIndex::Id id);
+
+    /**
+     * @brief Get the node at a position in the menu.
+     * 
+     * @param pos (const MenuPos&) position in the menu
+     * @return VcdNode* node at pos
+     */
+    VcdNode* menuNode(const MenuPos& pos);
+
+    /**
+     * @brief Get the scope containing the node at depth `level` of a 
+     * position in the menu.
+     * 
+     * @param pos (const MenuPos&) position in the menu
+     * @param level (size_t) depth of the node, 1 for children of the top
+     * @return VcdScope* parent scope
+     */
+    VcdScope* menuParent(const MenuPos& pos, size_t level);
+
+    /**
+     * @brief Moves a position to the next visible row of the menu.
+     * 
+     * @param pos (MenuPos&) position to move
+     * @return true if moved, false if pos is the last row
+     */
+    bool menuNext(MenuPos& pos);
+
+    /**
+     * @brief Moves a position to the previous visible row of the menu.
+     * 
+     * @param pos (MenuPos&) position to move
+     * @return true if moved, false if pos is the first row
+     */
+    bool menuPrev(MenuPos& pos);
+
+    /**
+     * @brief Moves a position to the last visible row of the menu.
+     * 
+     * @param pos (MenuPos&) position to move
+     */
+    void menuLast(MenuPos& pos);
+
+    /**
+     * @brief Expands a scope in the menu so its children are visible. This
+     * does not depend on the number of children.
      * 
-     * @param scope (std::list<MenuItem>::iterator) iterator of scope
-     * from visibleMenuItems to expand.
+     * @param scope (VcdNode*) scope to expand
      */
-    void expand(std::list<MenuItem>::iterator scope);
+    void expand(VcdNode* scope);
 
     /**
-     * @brief Collapses a scope menu item. All direct children of
-     * scope will be removed from visibleMenuItems.
+     * @brief Collapses a scope in the menu so its children are hidden.
      * 
-     * @param scope (std::list<MenuItem>::iterator) iterator of scope
-     * from visibleMenuItems to collapse.
+     * @param scope (VcdNode*) scope to collapse
      */
-    void collapse(std::list<MenuItem>::iterator scope);
+    void collapse(VcdNode* scope);
+
+    /**
+     * @brief Computes activity statistics of the selected signals over the
+     * run so far and displays them until the user returns: the peak and 
+     * average occupancy of each signal, then the toggles and percentage of
+     * time active of each index.
+     */
+    void displayStats();
+
+    /**
+     * @brief Computes the lifetimes of each index of a selected signal, 
+     * allocated while 1 (or nonzero), over the run so far and displays 
+     * their latency percentiles, histogram and the longest-lived entries 
+     * until the user returns. Choosing an entry jumps the table to its 
+     * allocation time and index.
+     * 
+     * @param name (std::string) name of the selected signal or derived column
+     * @param error (std::string&) set to the reason on error
+     * @return true on success, false on error
+     */
+    bool displayLifetimes(std::string name, std::string& error);
+
+    /**
+     * @brief Exports the selected signals over the run so far according to
+     * an export command like `out.csv every 10 from 100 to 500`; see 
+     * `Exporter::parseCommand`. The clock of `edge <clock>` must be selected.
+     * 
+     * @param command (std::string) export command from user input
+     * @param info (std::string&) set to a summary on success
+     * @param error (std::string&) set to the reason on error
+     * @return true on success, false on error
+     */
+    bool exportColumns(std::string command, std::string& info, std::string& error);
+
+    /**
+     * @brief Defines a derived column from a definition like 
+     * `ready = valid & ~stall` over the selected signals and selects it,
+     * or removes the derived column if the expression is empty.
+     * 
+     * @param definition (std::string) definition from user input
+     * @param error (std::string&) set to the reason on error
+     * @return true on success, false on error
+     */
+    bool defineColumn(std::string definition, std::string& error);
 
     /**
      * @brief Parses query_str into the query map of key->value format.
@@ -147,11 +413,29 @@ class TuiManager
     void displayMenuMode(VcdScope* top);
 
     /**
-     * @brief Set the max time of the digital waveform data.
+     * @brief Display the startup screen with the parser's report and
+     * progress until the definitions are parsed and the user continues.
+     */
+    void displayStartup();
+
+    /**
+     * @brief Set the parser providing the waveform data. Parsing may still
+     * be in progress; times up to the parser's frontier are made available.
+     * 
+     * @param parser (Waveform*) parser of the waveform file, or connection 
+     * to a server holding it
+     */
+    void setParser(Waveform* parser);
+
+    /**
+     * @brief Set the parser of a second waveform to compare against, such
+     * as another run of the same testbench. Cells of the table whose values
+     * differ from the matching signal of the second waveform are 
+     * highlighted. Parsing may still be in progress.
      * 
-     * @param time (uint64_t) max time
+     * @param parser (Parser*) parser of the second waveform file
      */
-    void setMaxTime(uint64_t time);
+    void setDiffParser(Parser* parser);
 
     /**
      * @brief Set the timescale 
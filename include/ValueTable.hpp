@@ -0,0 +1,109 @@
+/**
+ * Author:          Cynthia Wang
+ * Date created:    10/19/2026
+ * Organization:    ECE 4122
+ *
+ * Description:
+ * Header file for ValueTable class, which interns the values of bit
+ * vectors so each distinct value is stored once.
+*/
+
+#ifndef __VALUE_TABLE_HPP
+#define __VALUE_TABLE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+/**
+ * @brief Table of the distinct values of the bit vectors of a waveform,
+ * each stored once and referred to by a 32-bit id, since buses repeat the
+ * same few values (idle patterns, all x, all 0) over and over. The table
+ * is split into shards by the hash of a value, each with its own lock, so
+ * the threads publishing values intern them concurrently without a global
+ * lock. Ids never change, and looking up an id takes no lock, so lookups
+ * must not run concurrently with interning, which the values mutex of the
+ * `Parser` owning the table ensures.
+ *
+ * Ids are below `MAX_IDS`, so a var can tell them from ids of values it
+ * keeps itself once a shard of the table is full.
+ */
+class ValueTable
+{
+   public:
+    static constexpr uint32_t MAX_IDS = (uint32_t)1 << 31;
+    static constexpr uint32_t NONE = (uint32_t)-1; // returned when the table is full
+
+   private:
+    static constexpr unsigned SHARD_BITS = 6; // low bits of an id
+    static constexpr size_t NUM_SHARDS = 1 << SHARD_BITS;
+
+    /**
+     * @brief Data structure for a shard of the table, aligned so the locks
+     * of neighbouring shards do not share a cache line.
+     */
+    struct alignas(64) Shard
+    {
+        std::mutex mutex;
+        std::deque<std::string> values; // by id without the shard bits; never moved
+        std::unordered_map<std::string_view, uint32_t> ids; // views of values
+    };
+
+    Shard shards[NUM_SHARDS];
+
+    /**
+     * @brief Get the bytes allocated for a value in a shard.
+     */
+    static size_t getEntryBytes(const std::string& value);
+
+   public:
+    /**
+     * @brief Get the id of a value, adding it to the table if it is new.
+     * May be called from several threads at once.
+     *
+     * @param value (const std::string&) value as stored in the VCD file
+     * @param addedBytes (size_t&) set to the bytes allocated for the value
+     * if it was added, or to 0, so the caller that added a value can be
+     * charged for it
+     * @return uint32_t id of the value, or NONE if it is new and its shard
+     * of the table is full
+     */
+    uint32_t intern(const std::string& value, size_t& addedBytes);
+
+    /**
+     * @brief Get the value of an id.
+     *
+     * @param id (uint32_t) id returned by `intern`
+     * @return const std::string& value
+     */
+    const std::string& lookup(uint32_t id);
+
+    /**
+     * @brief Get the number of distinct values.
+     *
+     * @return size_t number of values
+     */
+    size_t size();
+
+    /**
+     * @brief Get an estimate of the bytes the table allocates.
+     *
+     * @return size_t bytes, not counting the object itself
+     */
+    size_t getMemoryBytes();
+
+    /**
+     * @brief Get an estimate of the bytes the table allocates besides the
+     * values themselves, i.e. the buckets of its hash tables, which are
+     * not charged to any var.
+     *
+     * @return size_t bytes
+     */
+    size_t getOverheadBytes();
+};
+
+#endif
@@ -11,11 +11,16 @@
 #ifndef __VCD_HPP
 #define __VCD_HPP
 
+#include <functional>
 #include <list>
+#include <memory>
 #include <string>
 #include <map>
+#include <unordered_map>
+#include <vector>
 
-#include <boost/icl/interval_map.hpp>
+#include "TimeColumn.hpp"
+#include "ValueTable.hpp"
 
 
 class VcdScope;
@@ -29,7 +34,7 @@ class VcdNode
     /**
      * @brief Enum for type of VcdNode
      */
-    enum Type { SCOPE, ARR_SCOPE, VAR };
+    enum Type { SCOPE, ARR_SCOPE, VAR, DERIVED };
 
    protected:
     std::string name;
@@ -65,6 +70,7 @@ class VcdNode
     Type getType();
     
     friend class Parser;
+    friend class RemoteWaveform;
 };
 
 /**
@@ -100,6 +106,7 @@ class VcdScope : public virtual VcdNode
     const std::map<std::string, VcdNode*>& getChildren();
     
     friend class Parser;
+    friend class RemoteWaveform;
 };
 
 /**
@@ -141,27 +148,78 @@ class VcdPrimitive : virtual public VcdNode
      * value; each element represents the value at an index.
      */
     virtual const std::vector<std::string> getValueAt(uint64_t time, size_t size) = 0;
+
+    /**
+     * @brief Get the value of the VcdPrimitive at the specified time for a window
+     * of `count` indices starting at `start` only, so that callers displaying part
+     * of a table do not have to retrieve every index.
+     * 
+     * @param time (uint64_t) time to query, unit based on VCD file's timescale.
+     * @param start (size_t) first index to retrieve.
+     * @param count (size_t) number of indices to retrieve; indices past the size
+     * of the primitive are padded.
+     * @return const std::vector<std::string> vector of `count` elements; element i
+     * represents the value at index `start + i`.
+     */
+    virtual const std::vector<std::string> getValueWindow(uint64_t time, size_t start, size_t count) = 0;
+
+    /**
+     * @brief Get the time of the first change of the VcdPrimitive's value
+     * at any index after the specified time.
+     * 
+     * @param time (uint64_t) time to query, unit based on VCD file's timescale.
+     * @return uint64_t time of the next change, or (uint64_t)-1 if there is
+     * none
+     */
+    virtual uint64_t getNextChange(uint64_t time) = 0;
 };
 
 
+class VcdStore;
+
 /**
- * @brief Class to represent a variable from a VCD file.
+ * @brief Class to represent a variable from a VCD file. Its values are
+ * kept in a `VcdStore`, shared with the vars declared with the same
+ * identifier code. Real and string vars have a single row.
  */
 class VcdVar : public VcdPrimitive 
 {
+   public:
+    /**
+     * @brief Enum for the kind of values of a VcdVar
+     */
+    enum ValueKind { VECTOR, REAL, STRING };
+
    private:
     size_t size;
     std::string dimensions;
     std::string hash;
-    std::list<std::pair<uint64_t, std::string>> vcdValues;
-    boost::icl::interval_map<uint64_t, std::string> intervalValues;
+    ValueKind valueKind;
+    std::shared_ptr<VcdStore> store; // none for a var held by a server
+
+    /**
+     * @brief Get the published value at the specified time from the store.
+     * Virtual so a var held by a server can be read the same way.
+     * 
+     * @param time (uint64_t) time to query
+     * @return const std::string value as stored in the VCD file
+     */
+    virtual const std::string valueAt(uint64_t time);
 
    public:
-    VcdVar() : VcdNode(VAR) 
+    VcdVar() : VcdNode(VAR), size(0), valueKind(VECTOR) 
     {}
 
     /**
-     * @brief Get the size of the var.
+     * @brief Get the kind of values of the var.
+     * 
+     * @return ValueKind kind of values
+     */
+    ValueKind getValueKind();
+
+    /**
+     * @brief Get the size of the var, which is 1 for a real or string var
+     * whatever size it is declared with.
      * 
      * @return size_t size
      */
@@ -185,16 +243,336 @@ class VcdVar : public VcdPrimitive
      */
     const std::vector<std::string> getValueAt(uint64_t time, size_t size);
 
+    /**
+     * @brief Get the value of the var at the specified time for a window of
+     * indices.
+     * 
+     * @param time (uint64_t) time to query, unit based on VCD file's timescale.
+     * @param start (size_t) first index to retrieve.
+     * @param count (size_t) number of indices to retrieve.
+     * @return const std::vector<std::string> vector of `count` elements.
+     */
+    const std::vector<std::string> getValueWindow(uint64_t time, size_t start, size_t count);
+
     /**
      * @brief Get the raw value (unvectorized) of the var at the specified
      * time. 
      * 
      * @param time (uint64_t) time to query, unit based on VCD file's timescale. 
-     * @return const std::string value as hex string
+     * @return const std::string value as hex string, or as displayed for a
+     * real or string var
      */
     const std::string getRawValueAt(uint64_t time);
+
+    /**
+     * @brief Get a window of indices of a value of the var, as stored in
+     * the VCD file, e.g. from a `DeltaEvent`, like `getValueWindow`.
+     * 
+     * @param value (const std::string&) value as stored in the VCD file
+     * @param start (size_t) first index to retrieve.
+     * @param count (size_t) number of indices to retrieve.
+     * @return const std::vector<std::string> vector of `count` elements.
+     */
+    const std::vector<std::string> getValueWindowOf(const std::string& value, size_t start, size_t count);
+
+    /**
+     * @brief Get the raw value of a value of the var, as stored in the VCD
+     * file, like `getRawValueAt`.
+     * 
+     * @param value (const std::string&) value as stored in the VCD file
+     * @return const std::string value as hex string, or as displayed for a
+     * real or string var
+     */
+    const std::string getRawValueOf(const std::string& value);
+
+    /**
+     * @brief Get the time of the first published change of the var after
+     * the specified time.
+     * 
+     * @param time (uint64_t) time to query, unit based on VCD file's timescale.
+     * @return uint64_t time of the next change, or (uint64_t)-1 if there is
+     * none
+     */
+    uint64_t getNextChange(uint64_t time);
+
+    /**
+     * @brief Calls `fn` for each published value of the var in time order
+     * with the range of times it holds, from the first change up to 
+     * `endTime`.
+     * 
+     * @param endTime (uint64_t) last time to include
+     * @param fn (const std::function<void(uint64_t, uint64_t, const std::string&)>&)
+     * called with the first time, the time after the last time, and the
+     * value as stored in the VCD file
+     */
+    virtual void forEachValue(uint64_t endTime, const std::function<void(uint64_t, uint64_t, const std::string&)>& fn);
+
+    /**
+     * @brief Calls `fn` for each published value of the var in time order
+     * like `forEachValue`, from the value in effect at `startTime`, until
+     * `fn` returns false.
+     * 
+     * @param startTime (uint64_t) time the first value holds, whose range
+     * may start before it
+     * @param endTime (uint64_t) last time to include
+     * @param fn (const std::function<bool(uint64_t, uint64_t, const std::string&)>&)
+     * called like the callback of `forEachValue`; returns false to stop
+     * @return false if `fn` stopped
+     */
+    bool forEachValueFrom(uint64_t startTime, uint64_t endTime, const std::function<bool(uint64_t, uint64_t, const std::string&)>& fn);
+
+    /**
+     * @brief Get a bit of a value as stored in the VCD file, extending
+     * it like a VCD vector value if it is shorter.
+     * 
+     * @param value (const std::string&) value as stored in the VCD file
+     * @param i (size_t) index of the bit, 0 being the least significant
+     * @return char '0', '1', 'x' or 'z'
+     */
+    static char bitAt(const std::string& value, size_t i);
+
+    /**
+     * @brief Get the kind of values of a `$var` declaration.
+     * 
+     * @param type (const std::string&) type of the declaration, e.g. `wire`
+     * or `real`
+     * @return ValueKind kind of values
+     */
+    static ValueKind kindOfType(const std::string& type);
+
+    /**
+     * @brief Formats a real value with the fewest digits that read back as
+     * the same value, e.g. `3.14`.
+     * 
+     * @param value (double) value
+     * @return std::string formatted value, or `x` for NaN
+     */
+    static std::string formatReal(double value);
+
+    /**
+     * @brief Get the value of a row of a table from a value as stored in
+     * the VCD file of a real or string var.
+     * 
+     * @param value (const std::string&) value as stored in the VCD file
+     * @return std::string value without its `r` or `s` prefix, with reals
+     * formatted like `formatReal`
+     */
+    static std::string displayTyped(const std::string& value);
+
+    /**
+     * @brief Get a value to compare with the values of a primitive in a
+     * query, so that e.g. `1.50` and `1.5e0` match the real 1.5.
+     * 
+     * @param primitive (VcdPrimitive*) column queried
+     * @param value (const std::string&) value in the query
+     * @return std::string value as displayed in the table
+     */
+    static std::string queryValue(VcdPrimitive* primitive, const std::string& value);
+
+    /**
+     * @brief Get the number of values stored for the var, published or not.
+     * Consecutive changes to the same value may be stored as one.
+     * 
+     * @return size_t number of values
+     */
+    virtual size_t getChangeCount();
+
+    /**
+     * @brief Estimate the bytes of memory used by the var and its values,
+     * including the nodes of the containers they are stored in.
+     * 
+     * @return size_t bytes
+     */
+    virtual size_t getMemoryBytes();
+
+    /**
+     * @brief Get the store of the values of the var, which its aliases share.
+     * 
+     * @return VcdStore* store, or nullptr for a var held by a server
+     */
+    VcdStore* getStore();
     
     friend class Parser;
+    friend class WaveformDiff;
+    friend class DerivedColumn;
+    friend class RemoteWaveform;
+    friend class Server;
+    friend class VcdAlias;
+};
+
+/**
+ * @brief Values of a var, which the vars declared with the same identifier
+ * code share. Bit vectors store the times of their changes in a compressed
+ * `TimeColumn`, with the id of each value in the `ValueTable` of the
+ * waveform, or for 1-bit vars only the values that do not simply toggle;
+ * real and string vars (`$var real`, `$var string`) are stored natively as
+ * one column of change times and one of doubles or of ids of interned
+ * strings.
+ */
+class VcdStore 
+{
+   private:
+    size_t size;
+    VcdVar::ValueKind valueKind;
+    std::list<std::pair<uint64_t, std::string>> vcdValues; // parsed but not yet published
+    std::pair<uint64_t, std::string> lastValue; // latest published change, open-ended
+    bool hasLastValue;
+
+    // published changes of a bit vector before lastValue, in time order
+    TimeColumn transitionTimes;
+    // 1-bit var: the value of each change that is not the complement of the
+    // one before, by position, so a clock stores one value
+    std::vector<std::pair<size_t, char>> transitionValues;
+    // wider var: the id of the value of each change in valueTable, or with
+    // OWN_VALUE set, in `strings` if valueTable was full
+    static constexpr uint32_t OWN_VALUE = ValueTable::MAX_IDS;
+    std::vector<uint32_t> transitionIds;
+    ValueTable* valueTable;
+    uint64_t internedBytes; // bytes of the values this store added to valueTable
+
+    // published changes of a real or string var, in time order
+    std::vector<uint64_t> changeTimes;
+    std::vector<double> realValues;                // NaN for an unknown value
+    std::vector<uint32_t> stringIds;               // index in `strings`
+    std::vector<std::string> strings;              // distinct values of a string var, or own values of a vector
+    std::unordered_map<std::string, uint32_t> stringIndex;
+
+    /**
+     * @brief Appends a published change of a real or string var, replacing
+     * a change at the same time and skipping a change to the same value.
+     * 
+     * @param time (uint64_t) time of the change
+     * @param value (const std::string&) value as stored in the VCD file,
+     * e.g. `r3.14` or `sIDLE`
+     */
+    void appendTypedValue(uint64_t time, const std::string& value);
+
+    /**
+     * @brief Appends a published change of a bit vector, skipping a change
+     * to the same value. Wider values are interned in `valueTable`, which
+     * may be done by several threads at once for different vars, and kept
+     * by the store itself if the table is full.
+     * 
+     * @param time (uint64_t) time of the change, after the last one
+     * @param value (const std::string&) value as stored in the VCD file,
+     * e.g. `1` or `b10x`
+     */
+    void appendTransition(uint64_t time, const std::string& value);
+
+    /**
+     * @brief Get the value of the transition at a position of a 1-bit var.
+     * 
+     * @param pos (size_t) position of the transition
+     * @return char value
+     */
+    char transitionBitAt(size_t pos);
+
+    /**
+     * @brief Get the value of the transition at a position of a bit vector.
+     * 
+     * @param pos (size_t) position of the transition
+     * @return const std::string value as stored in the VCD file
+     */
+    const std::string transitionValueAt(size_t pos);
+
+    /**
+     * @brief Get the value of the change at a position of the columns of a
+     * real or string var, as stored in the VCD file.
+     * 
+     * @param pos (size_t) position of the change
+     * @return const std::string value, or `x` for an unknown real
+     */
+    const std::string typedValueAt(size_t pos);
+
+    /**
+     * @brief Get the published value at the specified time, either from
+     * the columns of changes or from the latest change.
+     * 
+     * @param time (uint64_t) time to query
+     * @return const std::string value as stored in the VCD file
+     */
+    const std::string valueAt(uint64_t time);
+
+    /**
+     * @brief Get the time of the first published change after the
+     * specified time.
+     * 
+     * @param time (uint64_t) time to query
+     * @return uint64_t time of the next change, or (uint64_t)-1 if there is
+     * none
+     */
+    uint64_t getNextChange(uint64_t time);
+
+    /**
+     * @brief Calls `fn` for each published value in time order, like
+     * `VcdVar::forEachValueFrom`.
+     */
+    bool forEachValue(uint64_t startTime, uint64_t endTime, const std::function<bool(uint64_t, uint64_t, const std::string&)>& fn);
+
+   public:
+    /**
+     * @brief Construct a new empty VcdStore object.
+     * 
+     * @param size (size_t) size of the var
+     * @param valueKind (VcdVar::ValueKind) kind of values of the var
+     * @param valueTable (ValueTable*) table to intern the values of
+     * vectors wider than 1 bit in
+     */
+    VcdStore(size_t size, VcdVar::ValueKind valueKind, ValueTable* valueTable) 
+        : size(size), valueKind(valueKind), hasLastValue(false), valueTable(valueTable), internedBytes(0) 
+    {}
+
+    /**
+     * @brief Get the number of values stored, published or not.
+     * Consecutive changes to the same value may be stored as one.
+     * 
+     * @return size_t number of values
+     */
+    size_t getChangeCount();
+
+    /**
+     * @brief Estimate the bytes of memory used by the values, including
+     * the store and the nodes of the containers they are stored in.
+     * 
+     * @return size_t bytes
+     */
+    size_t getMemoryBytes();
+
+    friend class VcdVar;
+    friend class Parser;
+};
+
+/**
+ * @brief A var declared with the identifier code of an earlier var, e.g. a
+ * port connected through the hierarchy. It has its own name and parent,
+ * and shares the store of the earlier var, so values shared by several
+ * names are parsed and stored once and counted for the earlier var only.
+ */
+class VcdAlias : public VcdVar 
+{
+   public:
+    /**
+     * @brief Construct a new VcdAlias object with the size, kind of values
+     * and store of the var it aliases.
+     * 
+     * @param var (VcdVar*) var declared first with the identifier code
+     */
+    VcdAlias(VcdVar* var);
+
+    /**
+     * @brief Get the number of values stored for the alias, which is none
+     * since they are counted for the aliased var.
+     * 
+     * @return size_t 0
+     */
+    size_t getChangeCount();
+
+    /**
+     * @brief Estimate the bytes of memory used by the alias itself.
+     * 
+     * @return size_t bytes
+     */
+    size_t getMemoryBytes();
 };
 
 /**
@@ -203,6 +581,9 @@ class VcdVar : public VcdPrimitive
  */
 class VcdArrScope : public VcdScope, public VcdPrimitive 
 {
+   private:
+    std::vector<VcdVar*> elements; // children ordered by array index
+
    public:
     /**
      * @brief Construct a new VcdArrScope object
@@ -235,7 +616,39 @@ class VcdArrScope : public VcdScope, public VcdPrimitive
      * value; each element represents the value at an index.
      */
     const std::vector<std::string> getValueAt(uint64_t time, size_t size);
+
+    /**
+     * @brief Get the value of the unpacked array at the specified time for a
+     * window of indices. Only the elements inside the window are queried.
+     * 
+     * @param time (uint64_t) time to query, unit based on VCD file's timescale.
+     * @param start (size_t) first index to retrieve.
+     * @param count (size_t) number of indices to retrieve.
+     * @return const std::vector<std::string> vector of `count` elements.
+     */
+    const std::vector<std::string> getValueWindow(uint64_t time, size_t start, size_t count);
+
+    /**
+     * @brief Get the element of the unpacked array at an index.
+     * 
+     * @param index (size_t) array index
+     * @return VcdVar* element, or nullptr if the array has no such index
+     */
+    VcdVar* getElement(size_t index);
+
+    /**
+     * @brief Get the time of the first change of any element of the
+     * unpacked array after the specified time.
+     * 
+     * @param time (uint64_t) time to query, unit based on VCD file's timescale.
+     * @return uint64_t time of the next change, or (uint64_t)-1 if there is
+     * none
+     */
+    uint64_t getNextChange(uint64_t time);
     
     friend class Parser;
+    friend class WaveformDiff;
+    friend class DerivedColumn;
+    friend class RemoteWaveform;
 };
 #endif
\ No newline at end of file
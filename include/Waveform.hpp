@@ -0,0 +1,145 @@
+/**
+ * Author:          Cynthia Wang
+ * Date created:    10/19/2026
+ * Organization:    ECE 4122
+ *
+ * Description:
+ * Header file for Waveform interface, a source of a parsed waveform for
+ * the TUI and the headless modes.
+*/
+
+#ifndef __WAVEFORM_HPP
+#define __WAVEFORM_HPP
+
+#include <cstdint>
+#include <shared_mutex>
+#include <string>
+#include <vector>
+
+#include "SignalIndex.hpp"
+#include "Vcd.hpp"
+
+/**
+ * @brief One value change within a timestamp at which some var changes more
+ * than once (delta cycles). The events of a timestamp are kept in file
+ * order, so an event's index is its sequence number within the timestamp.
+ */
+struct DeltaEvent
+{
+    VcdVar* var;
+    std::string value; // value as stored in the VCD file
+    std::string previous; // value of var just before this event
+};
+
+/**
+ * @brief Interface of a parsed waveform: a tree of `VcdNode`s, the index
+ * over their names, and the progress of parsing. Implemented by `Parser`
+ * for a local file and by `RemoteWaveform` for a waveform held by a server.
+ */
+class Waveform
+{
+   public:
+    virtual ~Waveform()
+    {}
+
+    /**
+     * @brief Check if the tree of `VcdNode`s is complete.
+     *
+     * @return true if the definitions are done
+     */
+    virtual bool isDefinitionsDone() = 0;
+
+    /**
+     * @brief Check if all values have been parsed.
+     *
+     * @return true if parsing is done
+     */
+    virtual bool isDone() = 0;
+
+    /**
+     * @brief Get the number of bytes of the files parsed so far.
+     *
+     * @return uint64_t bytes read
+     */
+    virtual uint64_t getBytesRead() = 0;
+
+    /**
+     * @brief Get the total size of the files being parsed.
+     *
+     * @return uint64_t total bytes
+     */
+    virtual uint64_t getTotalBytes() = 0;
+
+    /**
+     * @brief Get the time elapsed since parsing started.
+     *
+     * @return double seconds
+     */
+    virtual double getParseSeconds() = 0;
+
+    /**
+     * @brief Get the lines of the report of parse times and file metadata.
+     *
+     * @return std::vector<std::string> copy of the report
+     */
+    virtual std::vector<std::string> getReport() = 0;
+
+    /**
+     * @brief Get the mutex to hold shared while reading values, while
+     * parsing may be in progress.
+     *
+     * @return std::shared_mutex& values mutex
+     */
+    virtual std::shared_mutex& getValuesMutex() = 0;
+
+    /**
+     * @brief Get the top scope.
+     *
+     * @return pointer to a VcdScope object
+     */
+    virtual VcdScope* getTop() = 0;
+
+    /**
+     * @brief Get the index over the full hierarchical names of all nodes.
+     * Valid once `isDefinitionsDone` returns true.
+     *
+     * @return SignalIndex& index
+     */
+    virtual SignalIndex& getIndex() = 0;
+
+    /**
+     * @brief Get the end time of the simulation, or the latest time whose
+     * values are published if parsing is still in progress.
+     *
+     * @return size_t end time
+     */
+    virtual size_t getMaxTime() = 0;
+
+    /**
+     * @brief Get the timescale, e.g. `1ps`.
+     *
+     * @return std::string timescale
+     */
+    virtual std::string getTimescale() = 0;
+
+    /**
+     * @brief Get every value change at `time`, in file order, if some var
+     * changes more than once at `time`. Values read at `time` are those of
+     * the last event of each var.
+     *
+     * @param time (uint64_t) time to get the events of
+     * @return std::vector<DeltaEvent> events, or empty if `time` has no
+     * delta cycles
+     */
+    virtual std::vector<DeltaEvent> getDeltaEvents(uint64_t time) = 0;
+
+    /**
+     * @brief Get the first time after `time` with delta cycles.
+     *
+     * @param time (uint64_t) time to search after
+     * @return uint64_t next time with delta cycles, or UINT64_MAX if none
+     */
+    virtual uint64_t getNextDeltaTime(uint64_t time) = 0;
+};
+
+#endif
@@ -0,0 +1,109 @@
+/**
+ * Author:          Cynthia Wang
+ * Date created:    10/19/2026
+ * Organization:    ECE 4122
+ *
+ * Description:
+ * Header file for WaveformDiff class, which compares the signals of two
+ * waveforms matched by hierarchical name.
+*/
+
+#ifndef __WAVEFORM_DIFF_HPP
+#define __WAVEFORM_DIFF_HPP
+
+#include <atomic>
+#include <shared_mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Vcd.hpp"
+
+/**
+ * @brief Compares pairs of matching signals from two waveforms, such as
+ * a passing and a failing run of the same testbench. Finds the first time
+ * any pair differs by merging the change times of both signals of each
+ * pair, searching the pairs in parallel.
+ */
+class WaveformDiff
+{
+   public:
+    static const uint64_t NONE = (uint64_t)-1;
+
+   private:
+    std::vector<std::pair<VcdVar*, VcdVar*>> pairs; // vars compared, one from each waveform
+    std::shared_mutex* mutexA; // guards the values of the first waveform, if any
+    std::shared_mutex* mutexB; // guards the values of the second waveform, if any
+
+    /**
+     * @brief Normalizes a value as stored in the VCD file to all of the
+     * bits of a var, since leading bits may be left out of vector values.
+     *
+     * @param value (const std::string&) value as stored in the VCD file
+     * @param size (size_t) size of the var
+     * @return std::string bits of the value, most significant first
+     */
+    static std::string normalize(const std::string& value, size_t size);
+
+    /**
+     * @brief Finds the first time after `time`, or at `time` if `inclusive`,
+     * where the vars of a pair differ, stopping past `limit` or past `best`,
+     * the earliest divergence found so far by any pair. Only times the
+     * value of either var changes need to be checked.
+     *
+     * @return uint64_t time of the divergence, or NONE
+     */
+    static uint64_t findPair(VcdVar* a, VcdVar* b, uint64_t time, bool inclusive, uint64_t limit,
+        const std::atomic<uint64_t>& best);
+
+   public:
+    /**
+     * @brief Construct a new WaveformDiff object with no pairs.
+     */
+    WaveformDiff() : mutexA(nullptr), mutexB(nullptr)
+    {}
+
+    /**
+     * @brief Sets the mutexes to hold shared while comparing values, for
+     * when the waveforms may still be written by parsers running in the
+     * background.
+     */
+    void setValuesMutexes(std::shared_mutex* a, std::shared_mutex* b);
+
+    /**
+     * @brief Sets the signals to compare. An unpacked array is compared
+     * element by element; pairs with different types or sizes are skipped.
+     *
+     * @param primitives (const std::vector<std::pair<VcdPrimitive*, VcdPrimitive*>>&)
+     * matching primitives, the first of each pair from the first waveform
+     * @return size_t number of pairs that could not be compared
+     */
+    size_t setPairs(const std::vector<std::pair<VcdPrimitive*, VcdPrimitive*>>& primitives);
+
+    /**
+     * @brief Checks whether two vars have different values at a time.
+     *
+     * @param a (VcdVar*) var of the first waveform
+     * @param b (VcdVar*) var of the second waveform
+     * @param time (uint64_t) time to compare
+     * @return true if the values differ
+     */
+    static bool differ(VcdVar* a, VcdVar* b, uint64_t time);
+
+    /**
+     * @brief Finds the first time at or after `time` where any pair differs
+     * if `inclusive`, otherwise the first time after `time` where any pair
+     * starts to differ or changes while differing. Pairs are searched in
+     * parallel, and a search stops early once it passes the earliest
+     * divergence found by the others.
+     *
+     * @param time (uint64_t) time to search from
+     * @param inclusive (bool) whether a difference at `time` itself counts
+     * @param limit (uint64_t) last time to search
+     * @return uint64_t time of the divergence, or NONE if there is none
+     * up to `limit`
+     */
+    uint64_t findDivergence(uint64_t time, bool inclusive, uint64_t limit);
+};
+
+#endif
@@ -0,0 +1,193 @@
+/**
+ * Author:          Cynthia Wang
+ * Date created:    10/19/2026
+ * Organization:    ECE 4122
+ *
+ * Description:
+ * Header file for WaveformFile class, the entry point of libtabuwave for
+ * programs that query waveforms without the TUI.
+*/
+
+#ifndef __WAVEFORM_FILE_HPP
+#define __WAVEFORM_FILE_HPP
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Vcd.hpp"
+#include "Waveform.hpp"
+
+/**
+ * @brief A waveform opened for queries, parsed from local files or held by
+ * a server started with `--serve`. Signals are named by their full
+ * hierarchical names (e.g. `TOP.scoreboard.scrbrd_vld`), times are in units
+ * of the timescale, and values are per index as shown in the table: a bit
+ * of a vector var, or an element of an unpacked array in hex.
+ *
+ * Methods return false and set the error returned by `getError` if the
+ * waveform is not open or a signal is not found.
+ */
+class WaveformFile
+{
+   public:
+    /**
+     * @brief A node of the hierarchy.
+     */
+    struct Signal
+    {
+        std::string path;   // full hierarchical name
+        VcdNode::Type type; // SCOPE, VAR or ARR_SCOPE
+        size_t size;        // number of indices, 0 for scopes
+    };
+
+   private:
+    std::unique_ptr<Waveform> waveform;
+    std::string error;
+
+    /**
+     * @brief Finds a var or unpacked array by full hierarchical name,
+     * setting the error if there is none.
+     *
+     * @return pointer to the VcdPrimitive, or nullptr
+     */
+    VcdPrimitive* findPrimitive(const std::string& path);
+
+    /**
+     * @brief Describes the node with the specified id in the index.
+     */
+    Signal describe(SignalIndex::Id id);
+
+   public:
+    /**
+     * @brief Parses a waveform, blocking until all values are parsed. A
+     * previously opened waveform is closed.
+     *
+     * @param files (const std::vector<std::string>&) paths to the VCD files
+     * of a dump, which may be split into several files
+     * @return true on success, false if a file could not be read or has
+     * no definitions
+     */
+    bool open(const std::vector<std::string>& files);
+
+    /**
+     * @brief Parses a waveform from one VCD file.
+     *
+     * @param file (const std::string&) path to the VCD file
+     * @return true on success
+     */
+    bool open(const std::string& file);
+
+    /**
+     * @brief Opens the waveform held by a server, waiting until the server
+     * has parsed it.
+     *
+     * @param socketPath (const std::string&) path of the server's socket
+     * @return true on success
+     */
+    bool connect(const std::string& socketPath);
+
+    /**
+     * @brief Get the reason the last call failed.
+     *
+     * @return const std::string& error
+     */
+    const std::string& getError();
+
+    /**
+     * @brief Get the opened waveform, for the classes of the library that
+     * take one (e.g. `Batch`, `Exporter`), or nullptr if none is open.
+     *
+     * @return Waveform* waveform
+     */
+    Waveform* getWaveform();
+
+    /**
+     * @brief Get the timescale, e.g. `1ps`.
+     *
+     * @return std::string timescale
+     */
+    std::string getTimescale();
+
+    /**
+     * @brief Get the end time of the simulation.
+     *
+     * @return uint64_t end time
+     */
+    uint64_t getEndTime();
+
+    /**
+     * @brief Lists the hierarchy under a scope.
+     *
+     * @param scope (const std::string&) full hierarchical name of a scope,
+     * or empty for the top scope itself
+     * @param recursive (bool) list all descendants instead of the children
+     * @param signals (std::vector<Signal>&) set to the nodes, in the order
+     * of the index
+     * @return true on success
+     */
+    bool list(const std::string& scope, bool recursive, std::vector<Signal>& signals);
+
+    /**
+     * @brief Searches signals by name like `/` in the menu.
+     *
+     * @param query (const std::string&) search terms
+     * @param limit (size_t) maximum number of matches
+     * @return std::vector<std::string> full hierarchical names of the best matches
+     */
+    std::vector<std::string> search(const std::string& query, size_t limit);
+
+    /**
+     * @brief Get the value of each index of a signal at a time.
+     *
+     * @param path (const std::string&) full hierarchical name
+     * @param time (uint64_t) time to query
+     * @param values (std::vector<std::string>&) set to the value of each index
+     * @return true on success
+     */
+    bool valueAt(const std::string& path, uint64_t time, std::vector<std::string>& values);
+
+    /**
+     * @brief Get the whole value of a var at a time as a hex string.
+     *
+     * @param path (const std::string&) full hierarchical name of a var
+     * @param time (uint64_t) time to query
+     * @param value (std::string&) set to the value
+     * @return true on success, false if the signal is not a var
+     */
+    bool rawValueAt(const std::string& path, uint64_t time, std::string& value);
+
+    /**
+     * @brief Calls `fn` with the value of each index of a signal at the
+     * start of a range and at each time it changes within the range.
+     *
+     * @param path (const std::string&) full hierarchical name
+     * @param start (uint64_t) first time
+     * @param end (uint64_t) last time, clamped to the end time
+     * @param fn (const std::function<void(uint64_t, const std::vector<std::string>&)>&)
+     * called with the time and the value of each index
+     * @return true on success
+     */
+    bool forEachChange(const std::string& path, uint64_t start, uint64_t end,
+        const std::function<void(uint64_t, const std::vector<std::string>&)>& fn);
+
+    /**
+     * @brief Calls `fn` with the values of several signals at every
+     * `period` time units of a range, like `every` in `--batch`.
+     *
+     * @param paths (const std::vector<std::string>&) full hierarchical names
+     * @param start (uint64_t) first time
+     * @param end (uint64_t) last time, clamped to the end time
+     * @param period (uint64_t) time between samples, greater than 0
+     * @param fn (const std::function<void(uint64_t, const std::vector<std::vector<std::string>>&)>&)
+     * called with the time and the value of each index of each signal, in
+     * the order of `paths`
+     * @return true on success
+     */
+    bool sample(const std::vector<std::string>& paths, uint64_t start, uint64_t end, uint64_t period,
+        const std::function<void(uint64_t, const std::vector<std::vector<std::string>>&)>& fn);
+};
+
+#endif
@@ -0,0 +1,232 @@
+/**
+ * Author:          Cynthia Wang
+ * Date created:    10/19/2026
+ * Organization:    ECE 4122
+ *
+ * Description:
+ * Source file for ActivityStats class and functions. See ActivityStats.hpp for function descriptions.
+*/
+
+#include "ActivityStats.hpp"
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+
+/**
+ * @brief Check whether a bit of a value is 0 or 1.
+ */
+static inline bool isKnown(char c)
+{
+    return c == '0' || c == '1';
+}
+
+void ActivityStats::setValuesMutex(std::shared_mutex* mutex)
+{
+    valuesMutex = mutex;
+}
+
+void ActivityStats::computeVar(VcdVar* var, uint64_t endTime, Signal& stats)
+{
+    size_t size = var->getSize();
+    stats.toggles.assign(size, 0);
+    stats.activeTime.assign(size, 0);
+    double weighted = 0;
+    std::string prev;
+    bool hasPrev = false;
+    if (var->getValueKind() != VcdVar::VECTOR)
+    {
+        // a real or string value has no bits: each change between known
+        // values toggles it, and it is active while known and not zero
+        var->forEachValue(endTime,
+            [&](uint64_t start, uint64_t end, const std::string& value)
+            {
+                bool known = (value != "x");
+                if (hasPrev && known && prev != "x") stats.toggles[0]++;
+                if (known && VcdVar::queryValue(var, VcdVar::displayTyped(value)) != "0")
+                {
+                    stats.activeTime[0] += end - start;
+                    if (!stats.peakOccupancy)
+                    {
+                        stats.peakOccupancy = 1;
+                        stats.peakTime = start;
+                    }
+                    weighted += end - start;
+                }
+                prev = value;
+                hasPrev = true;
+            }
+        );
+        stats.averageOccupancy = weighted / ((double)endTime + 1);
+        return;
+    }
+    var->forEachValue(endTime,
+        [&](uint64_t start, uint64_t end, const std::string& value)
+        {
+            uint64_t occupancy = 0;
+            for (size_t i = 0; i < size; i++)
+            {
+                char c = VcdVar::bitAt(value, i);
+                if (hasPrev)
+                {
+                    char p = VcdVar::bitAt(prev, i);
+                    if (isKnown(c) && isKnown(p) && c != p) stats.toggles[i]++;
+                }
+                if (c == '1')
+                {
+                    stats.activeTime[i] += end - start;
+                    occupancy++;
+                }
+            }
+            if (occupancy > stats.peakOccupancy)
+            {
+                stats.peakOccupancy = occupancy;
+                stats.peakTime = start;
+            }
+            weighted += (double)occupancy * (end - start);
+            prev = value;
+            hasPrev = true;
+        }
+    );
+    stats.averageOccupancy = weighted / ((double)endTime + 1);
+}
+
+void ActivityStats::computeElement(VcdVar* element, size_t index, uint64_t endTime, Signal& stats,
+    std::vector<std::pair<uint64_t, int>>& events)
+{
+    size_t size = element->getSize();
+    std::string prev;
+    bool hasPrev = false;
+    bool prevActive = false;
+    element->forEachValue(endTime,
+        [&](uint64_t start, uint64_t end, const std::string& value)
+        {
+            bool known = true;
+            bool changed = false;
+            bool active = false;
+            for (size_t i = 0; i < size; i++)
+            {
+                char c = VcdVar::bitAt(value, i);
+                known = known && isKnown(c);
+                active = active || (c == '1');
+                if (hasPrev) changed = changed || (c != VcdVar::bitAt(prev, i));
+            }
+            // a change is a toggle only between known values
+            bool prevKnown = hasPrev;
+            for (size_t i = 0; prevKnown && i < size; i++)
+            {
+                prevKnown = isKnown(VcdVar::bitAt(prev, i));
+            }
+            if (changed && known && prevKnown) stats.toggles[index]++;
+            if (active) stats.activeTime[index] += end - start;
+            if (active != prevActive) events.emplace_back(start, active ? 1 : -1);
+            prev = value;
+            hasPrev = true;
+            prevActive = active;
+        }
+    );
+    if (prevActive) events.emplace_back(endTime + 1, -1);
+}
+
+void ActivityStats::compute(const std::vector<std::pair<std::string, VcdPrimitive*>>& columns, uint64_t endTime)
+{
+    auto startTime = std::chrono::high_resolution_clock::now();
+    std::shared_lock<std::shared_mutex> lock;
+    if (valuesMutex) lock = std::shared_lock<std::shared_mutex>(*valuesMutex);
+
+    this->endTime = endTime;
+    signals.clear();
+    signals.reserve(columns.size());
+    std::vector<VcdPrimitive*> primitives;
+    for (auto& column : columns)
+    {
+        if (column.second->getType() != VcdNode::VAR && column.second->getType() != VcdNode::ARR_SCOPE) continue;
+        signals.push_back(Signal{column.first, {}, {}, 0, 0, 0});
+        primitives.push_back(column.second);
+    }
+
+    // one task per var, and one per element of each array
+    std::vector<std::vector<std::vector<std::pair<uint64_t, int>>>> events(signals.size()); // [signal][element]
+    std::vector<std::function<void()>> tasks;
+    for (size_t s = 0; s < signals.size(); s++)
+    {
+        Signal& stats = signals[s];
+        if (primitives[s]->getType() == VcdNode::VAR)
+        {
+            VcdVar* var = dynamic_cast<VcdVar*>(primitives[s]);
+            tasks.emplace_back([var, endTime, &stats]() { computeVar(var, endTime, stats); });
+            continue;
+        }
+        VcdArrScope* array = dynamic_cast<VcdArrScope*>(primitives[s]);
+        size_t size = array->getSize();
+        stats.toggles.assign(size, 0);
+        stats.activeTime.assign(size, 0);
+        events[s].resize(size);
+        for (size_t i = 0; i < size; i++)
+        {
+            VcdVar* element = array->getElement(i);
+            if (!element) continue;
+            std::vector<std::pair<uint64_t, int>>& elementEvents = events[s][i];
+            tasks.emplace_back([element, i, endTime, &stats, &elementEvents]()
+                {
+                    computeElement(element, i, endTime, stats, elementEvents);
+                }
+            );
+        }
+    }
+
+    ThreadPool::get().parallelFor(tasks.size(),
+        [&](size_t i, size_t)
+        {
+            tasks[i]();
+        }
+    );
+
+    // occupancy of each array from the times its elements become active
+    // or inactive, with inactive first at the same time
+    for (size_t s = 0; s < signals.size(); s++)
+    {
+        if (primitives[s]->getType() != VcdNode::ARR_SCOPE) continue;
+        std::vector<std::pair<uint64_t, int>> merged;
+        for (auto& elementEvents : events[s])
+        {
+            merged.insert(merged.end(), elementEvents.begin(), elementEvents.end());
+        }
+        std::sort(merged.begin(), merged.end());
+        Signal& stats = signals[s];
+        int64_t occupancy = 0;
+        double weighted = 0;
+        for (size_t i = 0; i < merged.size(); i++)
+        {
+            occupancy += merged[i].second;
+            uint64_t next = (i + 1 < merged.size()) ? merged[i + 1].first : endTime + 1;
+            if (next == merged[i].first) continue;
+            if ((uint64_t)occupancy > stats.peakOccupancy)
+            {
+                stats.peakOccupancy = occupancy;
+                stats.peakTime = merged[i].first;
+            }
+            weighted += (double)occupancy * (next - merged[i].first);
+        }
+        stats.averageOccupancy = weighted / ((double)endTime + 1);
+    }
+
+    std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - startTime;
+    seconds = elapsed.count();
+}
+
+const std::vector<ActivityStats::Signal>& ActivityStats::getSignals()
+{
+    return signals;
+}
+
+uint64_t ActivityStats::getEndTime()
+{
+    return endTime;
+}
+
+double ActivityStats::getSeconds()
+{
+    return seconds;
+}
@@ -0,0 +1,399 @@
+/**
+ * Author:          Cynthia Wang
+ * Date created:    10/19/2026
+ * Organization:    ECE 4122
+ *
+ * Description:
+ * Source file for Batch class and functions. See Batch.hpp for function descriptions.
+*/
+
+#include "Batch.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <functional>
+#include <queue>
+#include <sstream>
+
+#include <boost/algorithm/string.hpp>
+
+Batch::Batch(Waveform* parser)
+    : parser(parser), timescaleMultiplier(1), out(nullptr), current(0), buffered(0), spool(nullptr), spoolEnd(0)
+{
+    char unit[16] = "";
+    sscanf(parser->getTimescale().c_str(), "%llu %15s", (unsigned long long*)&timescaleMultiplier, unit);
+    if (!timescaleMultiplier) timescaleMultiplier = 1;
+    timescaleUnit = unit;
+}
+
+Batch::~Batch()
+{
+    if (spool) fclose(spool);
+}
+
+bool Batch::parseTime(const std::string& str, uint64_t& time)
+{
+    if (str.empty() || str.find_first_not_of("0123456789") != std::string::npos) return false;
+    try
+    {
+        time = std::stoull(str) / timescaleMultiplier;
+    }
+    catch (const std::out_of_range&)
+    {
+        return false;
+    }
+    return true;
+}
+
+void Batch::parseQuery(const std::string& line, Query& query)
+{
+    query.text = line;
+    query.rows = 0;
+    query.range = false;
+    query.start = query.end = query.period = 0;
+    query.pos = 0;
+    query.time = 0;
+    query.finished = false;
+    std::istringstream ss(line);
+    std::string signals, token;
+    uint64_t maxTime = parser->getMaxTime();
+
+    // signals
+    ss >> signals;
+    std::vector<std::string> names;
+    boost::split(names, signals, boost::is_any_of(","));
+    for (auto& name : names)
+    {
+        if (name.empty()) continue;
+        VcdPrimitive* primitive = dynamic_cast<VcdPrimitive*>(parser->getIndex().find(name));
+        if (!primitive)
+        {
+            query.error = "No signal " + name + ".";
+            return;
+        }
+        query.columns.emplace_back(name, primitive);
+        query.rows = std::max(query.rows, primitive->getSize());
+    }
+    if (query.columns.empty())
+    {
+        query.error = "No signals.";
+        return;
+    }
+
+    // times
+    ss >> token;
+    if (token == "at")
+    {
+        std::string list;
+        ss >> list;
+        std::vector<std::string> times;
+        boost::split(times, list, boost::is_any_of(","));
+        for (auto& str : times)
+        {
+            uint64_t time;
+            if (!parseTime(str, time))
+            {
+                query.error = "Invalid time " + str + ".";
+                return;
+            }
+            if (time > maxTime)
+            {
+                query.error = "Time " + str + " is past the end of the waveform.";
+                return;
+            }
+            query.times.push_back(time);
+        }
+        std::sort(query.times.begin(), query.times.end());
+        query.times.erase(std::unique(query.times.begin(), query.times.end()), query.times.end());
+    }
+    else if (token == "from")
+    {
+        std::string startStr, to, endStr;
+        uint64_t start, end, period = 0;
+        ss >> startStr >> to >> endStr;
+        if (!parseTime(startStr, start) || to != "to" || !parseTime(endStr, end) || start > end)
+        {
+            query.error = "Usage: from <time> to <time> [every <N>]";
+            return;
+        }
+        end = std::min(end, (uint64_t)maxTime);
+        std::streampos pos = ss.tellg();
+        if (ss >> token && token == "every")
+        {
+            std::string periodStr;
+            ss >> periodStr;
+            if (!parseTime(periodStr, period) || !period)
+            {
+                query.error = "Invalid period " + periodStr + ".";
+                return;
+            }
+        }
+        else
+        {
+            ss.clear();
+            ss.seekg(pos);
+        }
+        query.range = true;
+        query.start = start;
+        query.end = end;
+        query.period = period;
+    }
+    else
+    {
+        query.error = "Expected at or from after the signals.";
+        return;
+    }
+
+    // conditions, with the syntax of table mode
+    if (ss >> token)
+    {
+        std::string queryStr;
+        if (token != "where" || !(ss >> queryStr))
+        {
+            query.error = "Expected where <query_str> after the times.";
+            return;
+        }
+        std::vector<std::string> result;
+        boost::split(result, queryStr, boost::is_any_of("&"));
+        for (auto& q : result)
+        {
+            auto sep = q.find('=');
+            std::string key = q.substr(0, sep);
+            auto column = std::find_if(query.columns.begin(), query.columns.end(),
+                [&key](const std::pair<std::string, VcdPrimitive*>& column) { return column.first == key; });
+            if (sep == std::string::npos || sep + 1 == q.size() || column == query.columns.end())
+            {
+                query.error = "Invalid condition " + q + ".";
+                return;
+            }
+            std::vector<std::string> alternatives;
+            boost::split(alternatives, q.substr(sep + 1), boost::is_any_of("|"));
+            std::set<std::string> vals;
+            for (auto& alternative : alternatives)
+            {
+                vals.insert(VcdVar::queryValue(column->second, alternative));
+            }
+            query.conditions[key] = vals;
+        }
+        if (ss >> token)
+        {
+            query.error = "Unexpected " + token + ".";
+            return;
+        }
+    }
+}
+
+const std::vector<std::string>& Batch::valuesAt(VcdPrimitive* primitive, uint64_t time)
+{
+    auto it = decoded.find(primitive);
+    if (it == decoded.end())
+    {
+        it = decoded.emplace(primitive, Decoded{time, primitive->getValueWindow(time, 0, primitive->getSize())}).first;
+    }
+    else if (it->second.time != time)
+    {
+        it->second.time = time;
+        it->second.values = primitive->getValueWindow(time, 0, primitive->getSize());
+    }
+    return it->second.values;
+}
+
+void Batch::startSamples(Query& query)
+{
+    if (query.range)
+    {
+        query.time = query.start;
+        query.finished = query.start > query.end;
+    }
+    else
+    {
+        query.pos = 0;
+        query.finished = query.times.empty();
+        if (!query.finished) query.time = query.times[0];
+    }
+}
+
+void Batch::nextSample(Query& query)
+{
+    if (!query.range)
+    {
+        if (++query.pos < query.times.size())
+            query.time = query.times[query.pos];
+        else
+            query.finished = true;
+    }
+    else if (query.period)
+    {
+        if (query.end - query.time < query.period)
+            query.finished = true;
+        else
+            query.time += query.period;
+    }
+    else
+    {
+        // next change of any of the signals
+        uint64_t next = (uint64_t)-1;
+        for (auto& column : query.columns)
+        {
+            next = std::min(next, column.second->getNextChange(query.time));
+        }
+        if (next == (uint64_t)-1 || next > query.end)
+            query.finished = true;
+        else
+            query.time = next;
+    }
+}
+
+void Batch::answer(Query& query, uint64_t time)
+{
+    std::map<std::string, const std::vector<std::string>*> values;
+    for (auto& column : query.columns)
+    {
+        values[column.first] = &valuesAt(column.second, time);
+    }
+    static const std::string blank = "";
+    std::string timeStr = std::to_string(time * timescaleMultiplier);
+    std::string rows;
+    for (size_t i = 0; i < query.rows; i++)
+    {
+        bool match = true;
+        for (auto& condition : query.conditions)
+        {
+            const std::vector<std::string>& column = *values[condition.first];
+            if (!condition.second.count((i < column.size()) ? column[i] : blank))
+            {
+                match = false;
+                break;
+            }
+        }
+        if (!match) continue;
+        rows += timeStr;
+        rows += '\t';
+        rows += std::to_string(i);
+        for (auto& column : query.columns)
+        {
+            const std::vector<std::string>& value = *values[column.first];
+            rows += '\t';
+            rows += (i < value.size()) ? value[i] : blank;
+        }
+        rows += '\n';
+    }
+
+    if (&query == &queries[current])
+    {
+        *out << rows;
+        return;
+    }
+    query.output += rows;
+    buffered += rows.size();
+    if (buffered >= SPOOL_BYTES) spoolOutput();
+}
+
+void Batch::spoolOutput()
+{
+    if (!spool) spool = std::tmpfile();
+    if (!spool || fseeko(spool, spoolEnd, SEEK_SET) != 0) return;
+    for (auto& query : queries)
+    {
+        if (query.output.empty()) continue;
+        if (fwrite(query.output.data(), 1, query.output.size(), spool) != query.output.size())
+        {
+            // keep the rows in memory; the partial write is overwritten next time
+            fseeko(spool, spoolEnd, SEEK_SET);
+            return;
+        }
+        query.spooled.emplace_back(spoolEnd, query.output.size());
+        spoolEnd += query.output.size();
+        buffered -= query.output.size();
+        std::string().swap(query.output);
+    }
+}
+
+void Batch::printKept(Query& query)
+{
+    *out << "# " << query.text << "\n";
+    if (!query.error.empty())
+    {
+        *out << "# error: " << query.error << "\n";
+        return;
+    }
+    *out << "time_" << timescaleUnit << "\tindex";
+    for (auto& column : query.columns)
+    {
+        *out << "\t" << column.first;
+    }
+    *out << "\n";
+
+    char chunk[1 << 16];
+    for (auto& rows : query.spooled)
+    {
+        fflush(spool);
+        fseeko(spool, rows.first, SEEK_SET);
+        for (size_t left = rows.second; left > 0; )
+        {
+            size_t n = fread(chunk, 1, std::min(left, sizeof(chunk)), spool);
+            if (n == 0) break;
+            out->write(chunk, n);
+            left -= n;
+        }
+    }
+    query.spooled.clear();
+    *out << query.output;
+    buffered -= query.output.size();
+    std::string().swap(query.output);
+}
+
+void Batch::printFinished()
+{
+    while (current < queries.size() && queries[current].finished)
+    {
+        *out << "\n";
+        if (++current < queries.size()) printKept(queries[current]);
+    }
+}
+
+size_t Batch::run(std::istream& in, std::ostream& out)
+{
+    std::string line;
+    while (std::getline(in, line))
+    {
+        boost::algorithm::trim(line);
+        if (line.empty() || line[0] == '#') continue;
+        queries.emplace_back();
+        parseQuery(line, queries.back());
+    }
+
+    // the next sample time of every query, answered in time order and in
+    // the order of the queries at the same time
+    size_t failed = 0;
+    std::priority_queue<std::pair<uint64_t, size_t>, std::vector<std::pair<uint64_t, size_t>>, std::greater<>> samples;
+    for (size_t q = 0; q < queries.size(); q++)
+    {
+        if (!queries[q].error.empty())
+        {
+            queries[q].finished = true;
+            failed++;
+            continue;
+        }
+        startSamples(queries[q]);
+        if (!queries[q].finished) samples.emplace(queries[q].time, q);
+    }
+
+    this->out = &out;
+    current = 0;
+    if (!queries.empty()) printKept(queries[0]);
+    printFinished();
+    while (!samples.empty())
+    {
+        size_t q = samples.top().second;
+        samples.pop();
+        Query& query = queries[q];
+        answer(query, query.time);
+        nextSample(query);
+        if (!query.finished)
+            samples.emplace(query.time, q);
+        else if (q == current)
+            printFinished();
+    }
+    return failed;
+}
@@ -0,0 +1,499 @@
+/**
+ * Author:          Cynthia Wang
+ * Date created:    10/19/2026
+ * Organization:    ECE 4122
+ *
+ * Description:
+ * Source file for DerivedColumn class and functions. See DerivedColumn.hpp for function descriptions.
+*/
+
+#include "DerivedColumn.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <stdexcept>
+
+/**
+ * @brief Check whether a character can be part of the name of a column.
+ */
+static inline bool isNameChar(char c)
+{
+    return std::isalnum((unsigned char)c) || c == '_' || c == '[' || c == ']' || c == '.' || c == '$';
+}
+
+DerivedColumn::DerivedColumn(const std::string& name) : VcdNode(DERIVED), pos(0)
+{
+    this->name = name;
+}
+
+bool DerivedColumn::accept(const char* token)
+{
+    while (pos < input.size() && input[pos] == ' ') pos++;
+    size_t len = std::char_traits<char>::length(token);
+    if (input.compare(pos, len, token) != 0) return false;
+    pos += len;
+    return true;
+}
+
+std::unique_ptr<DerivedColumn::Expr> DerivedColumn::binary(Expr::Op op, std::unique_ptr<Expr> lhs, std::unique_ptr<Expr> rhs)
+{
+    auto node = std::make_unique<Expr>();
+    node->op = op;
+    node->column = nullptr;
+    node->rows = std::max(lhs->rows, rhs->rows);
+    node->width = (op == Expr::EQ || op == Expr::NE) ? 1 : std::max(lhs->width, rhs->width);
+    node->lhs = std::move(lhs);
+    node->rhs = std::move(rhs);
+    return node;
+}
+
+std::unique_ptr<DerivedColumn::Expr> DerivedColumn::parseOr(const std::map<std::string, VcdPrimitive*>& available)
+{
+    std::unique_ptr<Expr> lhs = parseXor(available);
+    while (lhs && accept("|"))
+    {
+        std::unique_ptr<Expr> rhs = parseXor(available);
+        if (!rhs) return nullptr;
+        lhs = binary(Expr::OR, std::move(lhs), std::move(rhs));
+    }
+    return lhs;
+}
+
+std::unique_ptr<DerivedColumn::Expr> DerivedColumn::parseXor(const std::map<std::string, VcdPrimitive*>& available)
+{
+    std::unique_ptr<Expr> lhs = parseAnd(available);
+    while (lhs && accept("^"))
+    {
+        std::unique_ptr<Expr> rhs = parseAnd(available);
+        if (!rhs) return nullptr;
+        lhs = binary(Expr::XOR, std::move(lhs), std::move(rhs));
+    }
+    return lhs;
+}
+
+std::unique_ptr<DerivedColumn::Expr> DerivedColumn::parseAnd(const std::map<std::string, VcdPrimitive*>& available)
+{
+    std::unique_ptr<Expr> lhs = parseEquality(available);
+    while (lhs && accept("&"))
+    {
+        std::unique_ptr<Expr> rhs = parseEquality(available);
+        if (!rhs) return nullptr;
+        lhs = binary(Expr::AND, std::move(lhs), std::move(rhs));
+    }
+    return lhs;
+}
+
+std::unique_ptr<DerivedColumn::Expr> DerivedColumn::parseEquality(const std::map<std::string, VcdPrimitive*>& available)
+{
+    std::unique_ptr<Expr> lhs = parseUnary(available);
+    while (lhs)
+    {
+        Expr::Op op;
+        if (accept("=="))
+            op = Expr::EQ;
+        else if (accept("!="))
+            op = Expr::NE;
+        else
+            break;
+        std::unique_ptr<Expr> rhs = parseUnary(available);
+        if (!rhs) return nullptr;
+        lhs = binary(op, std::move(lhs), std::move(rhs));
+    }
+    return lhs;
+}
+
+std::unique_ptr<DerivedColumn::Expr> DerivedColumn::parseUnary(const std::map<std::string, VcdPrimitive*>& available)
+{
+    Expr::Op op;
+    if (accept("~"))
+        op = Expr::NOT;
+    else if (accept("&"))
+        op = Expr::REDUCE_AND;
+    else if (accept("|"))
+        op = Expr::REDUCE_OR;
+    else if (accept("^"))
+        op = Expr::REDUCE_XOR;
+    else
+        return parsePrimary(available);
+
+    std::unique_ptr<Expr> operand = parseUnary(available);
+    if (!operand) return nullptr;
+    auto node = std::make_unique<Expr>();
+    node->op = op;
+    node->column = nullptr;
+    node->rows = operand->rows;
+    node->width = (op == Expr::NOT) ? operand->width : 1;
+    node->lhs = std::move(operand);
+    return node;
+}
+
+std::unique_ptr<DerivedColumn::Expr> DerivedColumn::parsePrimary(const std::map<std::string, VcdPrimitive*>& available)
+{
+    if (accept("("))
+    {
+        std::unique_ptr<Expr> node = parseOr(available);
+        if (!node) return nullptr;
+        if (!accept(")"))
+        {
+            error = "missing ')'";
+            return nullptr;
+        }
+        return node;
+    }
+
+    while (pos < input.size() && input[pos] == ' ') pos++;
+    size_t start = pos;
+    while (pos < input.size() && isNameChar(input[pos])) pos++;
+    std::string token = input.substr(start, pos - start);
+    if (token.empty())
+    {
+        error = (pos < input.size()) ? "unexpected '" + input.substr(pos, 1) + "'" : "missing operand";
+        return nullptr;
+    }
+
+    auto node = std::make_unique<Expr>();
+    node->column = nullptr;
+
+    // a column
+    auto it = available.find(token);
+    if (it != available.end())
+    {
+        VcdPrimitive* column = it->second;
+        VcdVar* var = dynamic_cast<VcdVar*>(column);
+        if (var && var->getValueKind() != VcdVar::VECTOR)
+        {
+            error = "column " + token + " is not a bit vector";
+            return nullptr;
+        }
+        node->op = Expr::COLUMN;
+        node->column = column;
+        node->rows = column->getSize();
+        if (column->getType() == VcdNode::DERIVED)
+        {
+            node->width = dynamic_cast<DerivedColumn*>(column)->expr->width;
+        }
+        else if (column->getType() == VcdNode::ARR_SCOPE)
+        {
+            node->width = 1;
+            for (VcdVar* element : dynamic_cast<VcdArrScope*>(column)->elements)
+            {
+                if (element) node->width = std::max(node->width, element->getSize());
+            }
+        }
+        else
+        {
+            node->width = 1;
+        }
+        columns.push_back(column);
+        return node;
+    }
+
+    // otherwise a constant, converted to binary
+    std::string bin;
+    std::string digits = token.substr(1);
+    if (std::all_of(token.begin(), token.end(), ::isdigit))
+    {
+        uint64_t value;
+        try
+        {
+            value = std::stoull(token);
+        }
+        catch (std::out_of_range&)
+        {
+            error = "constant " + token + " is too large";
+            return nullptr;
+        }
+        for (; value; value >>= 1) bin.insert(bin.begin(), (value & 1) ? '1' : '0');
+    }
+    else if (token[0] == 'h' && !digits.empty() && std::all_of(digits.begin(), digits.end(), ::isxdigit))
+    {
+        for (char c : digits)
+        {
+            int nibble = std::isdigit((unsigned char)c) ? c - '0' : std::tolower((unsigned char)c) - 'a' + 10;
+            for (int b = 3; b >= 0; b--) bin += ((nibble >> b) & 1) ? '1' : '0';
+        }
+    }
+    else if (token[0] == 'b' && !digits.empty() && digits.find_first_not_of("01xXzZ") == std::string::npos)
+    {
+        bin = digits;
+    }
+    else
+    {
+        error = "unknown column " + token;
+        return nullptr;
+    }
+    if (bin.empty()) bin = "0";
+
+    auto constant = std::make_shared<Bits>();
+    constant->rows = 0;
+    constant->planes.resize(bin.size());
+    constant->unknown.assign(1, 0);
+    for (size_t b = 0; b < bin.size(); b++)
+    {
+        char c = bin[bin.size() - 1 - b];
+        constant->planes[b].assign(1, (c == '1') ? ~0ULL : 0);
+        if (c != '0' && c != '1') constant->unknown[0] = ~0ULL;
+    }
+    node->op = Expr::CONSTANT;
+    node->constant = constant;
+    node->rows = 0;
+    node->width = bin.size();
+    return node;
+}
+
+bool DerivedColumn::parse(const std::string& expression, const std::map<std::string, VcdPrimitive*>& available)
+{
+    input = expression;
+    pos = 0;
+    error.clear();
+    columns.clear();
+    std::unique_ptr<Expr> parsed = parseOr(available);
+    if (parsed)
+    {
+        while (pos < input.size() && input[pos] == ' ') pos++;
+        if (pos < input.size()) error = "unexpected '" + input.substr(pos) + "'";
+    }
+    if (!parsed || !error.empty())
+    {
+        if (error.empty()) error = "invalid expression";
+        return false;
+    }
+    expr = std::move(parsed);
+    this->expression = expression;
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    cache.clear();
+    cacheOrder.clear();
+    return true;
+}
+
+const std::string& DerivedColumn::getError()
+{
+    return error;
+}
+
+const std::string& DerivedColumn::getExpression()
+{
+    return expression;
+}
+
+bool DerivedColumn::uses(VcdPrimitive* column)
+{
+    return std::find(columns.begin(), columns.end(), column) != columns.end();
+}
+
+std::shared_ptr<const DerivedColumn::Bits> DerivedColumn::load(VcdPrimitive* column, uint64_t time)
+{
+    if (column->getType() == VcdNode::DERIVED)
+        return dynamic_cast<DerivedColumn*>(column)->valuesAt(time);
+
+    auto bits = std::make_shared<Bits>();
+    bits->rows = column->getSize();
+    size_t words = (bits->rows + 63) / 64;
+    bits->unknown.assign(words, 0);
+    // set bit b of the value at index i from its character
+    auto set = [&bits](size_t b, size_t i, char c)
+    {
+        if (c == '1')
+            bits->planes[b][i / 64] |= 1ULL << (i % 64);
+        else if (c != '0')
+            bits->unknown[i / 64] |= 1ULL << (i % 64);
+    };
+
+    if (column->getType() == VcdNode::ARR_SCOPE)
+    {
+        // bit b of every element goes to plane b
+        std::vector<VcdVar*>& elements = dynamic_cast<VcdArrScope*>(column)->elements;
+        for (size_t i = 0; i < elements.size(); i++)
+        {
+            if (!elements[i]) continue;
+            size_t size = elements[i]->getSize();
+            if (bits->planes.size() < size) bits->planes.resize(size, std::vector<uint64_t>(words));
+            std::string value = elements[i]->valueAt(time);
+            for (size_t b = 0; b < size; b++)
+            {
+                set(b, i, VcdVar::bitAt(value, b));
+            }
+        }
+    }
+    else
+    {
+        // each index of a var is one bit
+        VcdVar* var = dynamic_cast<VcdVar*>(column);
+        bits->planes.assign(1, std::vector<uint64_t>(words));
+        std::string value = var->valueAt(time);
+        for (size_t i = 0; i < bits->rows; i++)
+        {
+            set(0, i, VcdVar::bitAt(value, i));
+        }
+    }
+    return bits;
+}
+
+std::shared_ptr<const DerivedColumn::Bits> DerivedColumn::evaluate(const Expr& node, uint64_t time)
+{
+    if (node.op == Expr::COLUMN) return load(node.column, time);
+    if (node.op == Expr::CONSTANT) return node.constant;
+
+    std::shared_ptr<const Bits> a = evaluate(*node.lhs, time);
+    std::shared_ptr<const Bits> b = node.rhs ? evaluate(*node.rhs, time) : nullptr;
+    auto result = std::make_shared<Bits>();
+    result->rows = node.rows;
+    size_t words = node.rows ? (node.rows + 63) / 64 : 1;
+    result->planes.assign(node.width, std::vector<uint64_t>(words));
+    result->unknown.assign(words, 0);
+    std::vector<std::vector<uint64_t>>& out = result->planes;
+
+    // each operator is a loop over words of 64 indices
+    size_t width = std::max(a->planes.size(), b ? b->planes.size() : 0);
+    for (size_t w = 0; w < words; w++)
+    {
+        result->unknown[w] = a->unknownWord(w) | (b ? b->unknownWord(w) : 0);
+    }
+    switch (node.op)
+    {
+        case Expr::NOT:
+            for (size_t p = 0; p < node.width; p++)
+                for (size_t w = 0; w < words; w++) out[p][w] = ~a->word(p, w);
+            break;
+        case Expr::AND:
+            for (size_t p = 0; p < node.width; p++)
+                for (size_t w = 0; w < words; w++) out[p][w] = a->word(p, w) & b->word(p, w);
+            break;
+        case Expr::OR:
+            for (size_t p = 0; p < node.width; p++)
+                for (size_t w = 0; w < words; w++) out[p][w] = a->word(p, w) | b->word(p, w);
+            break;
+        case Expr::XOR:
+            for (size_t p = 0; p < node.width; p++)
+                for (size_t w = 0; w < words; w++) out[p][w] = a->word(p, w) ^ b->word(p, w);
+            break;
+        case Expr::REDUCE_AND:
+            for (size_t w = 0; w < words; w++) out[0][w] = ~0ULL;
+            for (size_t p = 0; p < width; p++)
+                for (size_t w = 0; w < words; w++) out[0][w] &= a->word(p, w);
+            break;
+        case Expr::REDUCE_OR:
+            for (size_t p = 0; p < width; p++)
+                for (size_t w = 0; w < words; w++) out[0][w] |= a->word(p, w);
+            break;
+        case Expr::REDUCE_XOR:
+            for (size_t p = 0; p < width; p++)
+                for (size_t w = 0; w < words; w++) out[0][w] ^= a->word(p, w);
+            break;
+        case Expr::EQ:
+        case Expr::NE:
+            // indices with any differing bit
+            for (size_t p = 0; p < width; p++)
+                for (size_t w = 0; w < words; w++) out[0][w] |= a->word(p, w) ^ b->word(p, w);
+            if (node.op == Expr::EQ)
+                for (size_t w = 0; w < words; w++) out[0][w] = ~out[0][w];
+            break;
+        default:
+            break;
+    }
+
+    // clear the bits past the last index so they read as zero when extended
+    if (node.rows % 64)
+    {
+        uint64_t mask = (1ULL << (node.rows % 64)) - 1;
+        for (auto& plane : out) plane[words - 1] &= mask;
+        result->unknown[words - 1] &= mask;
+    }
+    return result;
+}
+
+std::shared_ptr<const DerivedColumn::Bits> DerivedColumn::valuesAt(uint64_t time)
+{
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        auto it = cache.find(time);
+        if (it != cache.end()) return it->second;
+    }
+
+    // evaluate without holding the lock so other times can be evaluated
+    // at the same time
+    std::shared_ptr<const Bits> values = evaluate(*expr, time);
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    if (cache.emplace(time, values).second)
+    {
+        cacheOrder.push_back(time);
+        if (cacheOrder.size() > CACHE_SIZE)
+        {
+            cache.erase(cacheOrder.front());
+            cacheOrder.pop_front();
+        }
+    }
+    return values;
+}
+
+size_t DerivedColumn::getSize()
+{
+    // a constant expression has one index
+    return std::max(expr->rows, (size_t)1);
+}
+
+size_t DerivedColumn::getWidth()
+{
+    if (expr->width == 1) return name.size() + 1;
+    return std::max(name.size() + 1, (size_t)ceil(expr->width / 4.0) + 2);
+}
+
+const std::vector<std::string> DerivedColumn::getValueAt(uint64_t time, size_t size)
+{
+    return getValueWindow(time, 0, size);
+}
+
+const std::vector<std::string> DerivedColumn::getValueWindow(uint64_t time, size_t start, size_t count)
+{
+    std::shared_ptr<const Bits> values = valuesAt(time);
+    size_t size = getSize();
+    size_t width = expr->width;
+    size_t numDigits = (width + 3) / 4;
+    std::vector<std::string> value_vec;
+    value_vec.reserve(count);
+    for (size_t i = start; i < start + count; i++)
+    {
+        if (i >= size)
+        {
+            value_vec.emplace_back(" ");
+            continue;
+        }
+        size_t w = i / 64;
+        uint64_t mask = 1ULL << (i % 64);
+        if (values->unknownWord(w) & mask)
+        {
+            value_vec.emplace_back((width == 1) ? "x" : 'h' + std::string(numDigits, 'x'));
+        }
+        else if (width == 1)
+        {
+            value_vec.emplace_back((values->word(0, w) & mask) ? "1" : "0");
+        }
+        else
+        {
+            // format like the raw values of unpacked arrays
+            std::string value(numDigits + 1, 'h');
+            for (size_t d = 0; d < numDigits; d++)
+            {
+                int nibble = 0;
+                for (size_t k = 0; k < 4; k++)
+                {
+                    if (values->word(4 * d + k, w) & mask) nibble |= 1 << k;
+                }
+                value[numDigits - d] = "0123456789abcdef"[nibble];
+            }
+            value_vec.emplace_back(value);
+        }
+    }
+    return value_vec;
+}
+
+uint64_t DerivedColumn::getNextChange(uint64_t time)
+{
+    uint64_t next = (uint64_t)-1;
+    for (VcdPrimitive* column : columns)
+    {
+        next = std::min(next, column->getNextChange(time));
+    }
+    return next;
+}
@@ -0,0 +1,471 @@
+/**
+ * Author:          Cynthia Wang
+ * Date created:    10/19/2026
+ * Organization:    ECE 4122
+ *
+ * Description:
+ * Source file for Exporter class and functions. See Exporter.hpp for function descriptions.
+*/
+
+#include "Exporter.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <queue>
+#include <sstream>
+
+#define NO_CHANGE ((uint64_t)-1)
+
+void Exporter::setValuesMutex(std::shared_mutex* mutex)
+{
+    valuesMutex = mutex;
+}
+
+void Exporter::setColumns(const std::vector<std::pair<std::string, VcdPrimitive*>>& columns)
+{
+    names.clear();
+    sources.clear();
+    for (auto& column : columns)
+    {
+        if (column.second->getType() == VcdNode::VAR)
+        {
+            sources.push_back(Source{column.second, dynamic_cast<VcdVar*>(column.second), names.size(), 1});
+            names.push_back(column.first);
+        }
+        else if (column.second->getType() == VcdNode::ARR_SCOPE)
+        {
+            // each element changes on its own, so merge them separately
+            VcdArrScope* array = dynamic_cast<VcdArrScope*>(column.second);
+            for (size_t i = 0; i < array->getSize(); i++)
+            {
+                VcdVar* element = array->getElement(i);
+                if (!element) continue;
+                sources.push_back(Source{element, element, names.size(), 1});
+                names.push_back(column.first + "[" + std::to_string(i) + "]");
+            }
+        }
+        else
+        {
+            size_t size = column.second->getSize();
+            sources.push_back(Source{column.second, nullptr, names.size(), size});
+            for (size_t i = 0; i < size; i++)
+            {
+                names.push_back((size == 1) ? column.first : column.first + "[" + std::to_string(i) + "]");
+            }
+        }
+    }
+}
+
+bool Exporter::load(Source& source, uint64_t time)
+{
+    bool any = false;
+    if (source.var)
+    {
+        std::string value = (source.var->getSize() > 1)
+            ? source.var->getRawValueAt(time)
+            : source.var->getValueWindow(time, 0, 1)[0];
+        if (value != values[source.column])
+        {
+            values[source.column] = std::move(value);
+            changed[source.column] = true;
+            any = true;
+        }
+        return any;
+    }
+    std::vector<std::string> window = source.primitive->getValueWindow(time, 0, source.count);
+    for (size_t i = 0; i < source.count; i++)
+    {
+        if (window[i] != values[source.column + i])
+        {
+            values[source.column + i] = std::move(window[i]);
+            changed[source.column + i] = true;
+            any = true;
+        }
+    }
+    return any;
+}
+
+bool Exporter::isHigh(VcdPrimitive* clock, uint64_t time)
+{
+    return clock->getValueWindow(time, 0, 1)[0] == "1";
+}
+
+void Exporter::appendVarint(std::string& buffer, uint64_t value)
+{
+    while (value >= 0x80)
+    {
+        buffer.push_back((char)(0x80 | (value & 0x7f)));
+        value >>= 7;
+    }
+    buffer.push_back((char)value);
+}
+
+void Exporter::appendString(std::string& buffer, const std::string& str)
+{
+    appendVarint(buffer, str.size());
+    buffer += str;
+}
+
+void Exporter::appendJson(std::string& buffer, const std::string& str)
+{
+    buffer.push_back('"');
+    for (char c : str)
+    {
+        if (c == '"' || c == '\\') buffer.push_back('\\');
+        buffer.push_back(c);
+    }
+    buffer.push_back('"');
+}
+
+void Exporter::appendCsv(std::string& buffer, const std::string& str)
+{
+    if (str.find_first_of(",\"\n") == std::string::npos)
+    {
+        buffer += str;
+        return;
+    }
+    buffer.push_back('"');
+    for (char c : str)
+    {
+        if (c == '"') buffer.push_back('"');
+        buffer.push_back(c);
+    }
+    buffer.push_back('"');
+}
+
+void Exporter::writeHeader(std::ostream& out, const Options& options)
+{
+    line.clear();
+    switch (options.format)
+    {
+    case CSV:
+        line += "time_" + options.timescaleUnit;
+        for (auto& name : names)
+        {
+            line.push_back(',');
+            appendCsv(line, name);
+        }
+        line.push_back('\n');
+        break;
+    case JSONL:
+        keys.clear();
+        for (auto& name : names)
+        {
+            std::string key(",");
+            appendJson(key, name);
+            key.push_back(':');
+            keys.push_back(key);
+        }
+        break;
+    case BINARY:
+        line += "TBWX";
+        line.push_back(1);
+        appendString(line, options.timescaleUnit);
+        appendVarint(line, names.size());
+        for (auto& name : names)
+        {
+            appendString(line, name);
+        }
+        break;
+    }
+    out.write(line.data(), line.size());
+}
+
+void Exporter::writeRow(std::ostream& out, const Options& options, uint64_t time)
+{
+    time *= options.timescaleMultiplier;
+    line.clear();
+    switch (options.format)
+    {
+    case CSV:
+        line += std::to_string(time);
+        for (auto& value : values)
+        {
+            line.push_back(',');
+            appendCsv(line, value);
+        }
+        line.push_back('\n');
+        break;
+    case JSONL:
+        line += "{\"time_" + options.timescaleUnit + "\":" + std::to_string(time);
+        for (size_t c = 0; c < values.size(); c++)
+        {
+            line += keys[c];
+            appendJson(line, values[c]);
+        }
+        line += "}\n";
+        break;
+    case BINARY:
+        appendVarint(blockTimes, time - lastTime);
+        for (size_t c = 0; c < values.size(); c++)
+        {
+            if (blockRows % 8 == 0) blockBitmaps[c].push_back(0);
+            if (changed[c] || blockRows == 0)
+            {
+                blockBitmaps[c].back() |= (char)(1 << (blockRows % 8));
+                appendString(blockValues[c], values[c]);
+            }
+        }
+        if (++blockRows == BLOCK_ROWS) flushBlock(out);
+        break;
+    }
+    lastTime = time;
+    if (!line.empty()) out.write(line.data(), line.size());
+}
+
+void Exporter::flushBlock(std::ostream& out)
+{
+    if (!blockRows) return;
+    std::string header;
+    appendVarint(header, blockRows);
+    out.write(header.data(), header.size());
+    out.write(blockTimes.data(), blockTimes.size());
+    for (size_t c = 0; c < names.size(); c++)
+    {
+        out.write(blockBitmaps[c].data(), blockBitmaps[c].size());
+        out.write(blockValues[c].data(), blockValues[c].size());
+        blockBitmaps[c].clear();
+        blockValues[c].clear();
+    }
+    blockTimes.clear();
+    blockRows = 0;
+}
+
+bool Exporter::write(std::ostream& out, const Options& options)
+{
+    auto startTime = std::chrono::high_resolution_clock::now();
+    error.clear();
+    rows = 0;
+    if (names.empty())
+    {
+        error = "No signals to export.";
+        return false;
+    }
+    if (options.startTime > options.endTime)
+    {
+        error = "Start of the range is after its end.";
+        return false;
+    }
+    if (options.clock && (options.clock->getType() == VcdNode::ARR_SCOPE || options.clock->getSize() != 1))
+    {
+        error = "Clock must be a single bit.";
+        return false;
+    }
+
+    std::shared_lock<std::shared_mutex> lock;
+    if (valuesMutex) lock = std::shared_lock<std::shared_mutex>(*valuesMutex);
+
+    values.assign(names.size(), "");
+    changed.assign(names.size(), false);
+    blockTimes.clear();
+    blockValues.assign(names.size(), "");
+    blockBitmaps.assign(names.size(), "");
+    blockRows = 0;
+    lastTime = 0;
+    writeHeader(out, options);
+
+    // min-heap of the next change of each source, with every source
+    // loaded at the first sample
+    typedef std::pair<uint64_t, size_t> Change;
+    std::priority_queue<Change, std::vector<Change>, std::greater<Change>> changes;
+
+    // time of the next sample after a time, or NO_CHANGE past the end
+    std::function<uint64_t(uint64_t)> nextSample;
+    if (options.clock)
+    {
+        nextSample = [&options](uint64_t time)
+        {
+            do
+            {
+                time = options.clock->getNextChange(time);
+            } while (time != NO_CHANGE && time <= options.endTime && !isHigh(options.clock, time));
+            return (time <= options.endTime) ? time : NO_CHANGE;
+        };
+    }
+    else if (options.period)
+    {
+        nextSample = [&options](uint64_t time)
+        {
+            return (options.endTime - time >= options.period) ? time + options.period : NO_CHANGE;
+        };
+    }
+    else
+    {
+        nextSample = [&changes](uint64_t)
+        {
+            return changes.empty() ? NO_CHANGE : changes.top().first;
+        };
+    }
+
+    uint64_t time = options.startTime;
+    if (options.clock)
+    {
+        // a rising edge at the start counts
+        bool edge = isHigh(options.clock, time) && (time == 0 || !isHigh(options.clock, time - 1));
+        if (!edge) time = nextSample(time);
+    }
+    if (time != NO_CHANGE)
+    {
+        for (size_t s = 0; s < sources.size(); s++)
+        {
+            changes.emplace(time, s);
+        }
+    }
+
+    while (time != NO_CHANGE)
+    {
+        // load the sources that changed since the last sample
+        bool any = false;
+        while (!changes.empty() && changes.top().first <= time)
+        {
+            Source& source = sources[changes.top().second];
+            changes.pop();
+            any = load(source, time) || any;
+            uint64_t next = source.primitive->getNextChange(time);
+            if (next != NO_CHANGE && next <= options.endTime) changes.emplace(next, &source - sources.data());
+        }
+
+        // a derived column may report a change that leaves its value the same
+        if (any || options.clock || options.period)
+        {
+            writeRow(out, options, time);
+            std::fill(changed.begin(), changed.end(), false);
+            rows++;
+            if (!out)
+            {
+                error = "Could not write the export.";
+                return false;
+            }
+            // let the parser publish between blocks of rows
+            if (rows % BLOCK_ROWS == 0 && lock.owns_lock())
+            {
+                lock.unlock();
+                lock.lock();
+            }
+        }
+        time = nextSample(time);
+    }
+    if (options.format == BINARY)
+    {
+        flushBlock(out);
+        line.clear();
+        appendVarint(line, 0);
+        out.write(line.data(), line.size());
+    }
+    out.flush();
+    if (!out)
+    {
+        error = "Could not write the export.";
+        return false;
+    }
+
+    std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - startTime;
+    seconds = elapsed.count();
+    return true;
+}
+
+/**
+ * @brief Parses a whole string as an unsigned number.
+ */
+static bool parseNumber(const std::string& str, uint64_t& number)
+{
+    if (str.empty() || str.find_first_not_of("0123456789") != std::string::npos) return false;
+    try
+    {
+        number = std::stoull(str);
+    }
+    catch (const std::out_of_range&)
+    {
+        return false;
+    }
+    return true;
+}
+
+bool Exporter::parseCommand(const std::string& command, Options& options, std::string& path,
+    std::string& clockName, std::string& error)
+{
+    std::istringstream ss(command);
+    std::string token;
+    if (!(ss >> path))
+    {
+        error = "Usage: <path> [csv|jsonl|bin] [every <N> | edge <clock>] [from <time>] [to <time>]";
+        return false;
+    }
+    bool hasFormat = false;
+    while (ss >> token)
+    {
+        if (token == "csv" || token == "jsonl" || token == "json" || token == "bin")
+        {
+            options.format = (token == "csv") ? CSV : (token == "bin") ? BINARY : JSONL;
+            hasFormat = true;
+        }
+        else if (token == "edge")
+        {
+            if (!(ss >> clockName))
+            {
+                error = "Missing clock after edge.";
+                return false;
+            }
+            options.period = 0;
+        }
+        else if (token == "every" || token == "from" || token == "to")
+        {
+            std::string arg;
+            uint64_t number;
+            if (!(ss >> arg) || !parseNumber(arg, number))
+            {
+                error = "Missing or invalid number after " + token + ".";
+                return false;
+            }
+            number /= options.timescaleMultiplier;
+            if (token == "every")
+            {
+                if (!number)
+                {
+                    error = "Period must be at least one timescale unit.";
+                    return false;
+                }
+                options.period = number;
+                options.clock = nullptr;
+                clockName.clear();
+            }
+            else if (token == "from")
+            {
+                options.startTime = number;
+            }
+            else
+            {
+                options.endTime = number;
+            }
+        }
+        else
+        {
+            error = "Unknown export option " + token + ".";
+            return false;
+        }
+    }
+    if (!hasFormat)
+    {
+        // take the format from the extension, defaulting to CSV
+        std::string extension = path.substr(std::min(path.rfind('.'), path.size()));
+        options.format = (extension == ".jsonl" || extension == ".json") ? JSONL
+            : (extension == ".bin") ? BINARY : CSV;
+    }
+    return true;
+}
+
+const std::string& Exporter::getError()
+{
+    return error;
+}
+
+uint64_t Exporter::getRows()
+{
+    return rows;
+}
+
+double Exporter::getSeconds()
+{
+    return seconds;
+}
@@ -0,0 +1,162 @@
+/**
+ * Author:          Cynthia Wang
+ * Date created:    10/19/2026
+ * Organization:    ECE 4122
+ *
+ * Description:
+ * Source file for FrameCache class and functions. See FrameCache.hpp for function descriptions.
+*/
+
+#include "FrameCache.hpp"
+
+#include "ThreadPool.hpp"
+#include "Trace.hpp"
+
+FrameCache::FrameCache(size_t capacity, size_t prefetchDepth)
+    : capacity(capacity), prefetchDepth(prefetchDepth), stopping(false), runningTasks(0), valuesMutex(nullptr),
+      start(0), count(0), generation(0)
+{
+    // prefetch only on workers, never on the thread waiting for input
+    maxTasks = std::min(ThreadPool::get().getWorkers(), std::max(prefetchDepth / 4, (size_t)1));
+}
+
+FrameCache::~FrameCache()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    stopping = true;
+    tasksDone.wait(lock, [this]() { return runningTasks == 0; });
+}
+
+void FrameCache::setValuesMutex(std::shared_mutex* mutex)
+{
+    valuesMutex = mutex;
+}
+
+std::shared_ptr<const FrameCache::Frame> FrameCache::decode(const Columns& columns, size_t start, size_t count, uint64_t time)
+{
+    Trace::Span span("decode frame", "ui");
+    std::shared_lock<std::shared_mutex> lock;
+    if (valuesMutex) lock = std::shared_lock<std::shared_mutex>(*valuesMutex);
+    auto frame = std::make_shared<Frame>();
+    for (auto& col : columns)
+    {
+        (*frame)[col.first] = col.second->getValueWindow(time, start, count);
+    }
+    return frame;
+}
+
+void FrameCache::insert(uint64_t time, std::shared_ptr<const Frame> frame)
+{
+    if (entries.count(time)) return;
+    while (entries.size() >= capacity && !lru.empty())
+    {
+        entries.erase(lru.back());
+        lru.pop_back();
+    }
+    lru.push_front(time);
+    entries[time] = Entry{frame, lru.begin()};
+}
+
+void FrameCache::setWindow(const Columns& newColumns, size_t newStart, size_t newCount)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (newColumns == columns && newStart == start && newCount == count) return;
+    columns = newColumns;
+    start = newStart;
+    count = newCount;
+    generation++;
+    entries.clear();
+    lru.clear();
+    pending.clear();
+}
+
+std::shared_ptr<const FrameCache::Frame> FrameCache::get(uint64_t time)
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    auto it = entries.find(time);
+    if (it != entries.end())
+    {
+        // cache hit, mark as most recently used
+        lru.splice(lru.begin(), lru, it->second.lruPos);
+        return it->second.frame;
+    }
+
+    // cache miss, decode without holding the lock
+    Columns currColumns = columns;
+    size_t currStart = start;
+    size_t currCount = count;
+    uint64_t currGeneration = generation;
+    lock.unlock();
+    auto frame = decode(currColumns, currStart, currCount, time);
+    lock.lock();
+    if (currGeneration == generation) insert(time, frame);
+    return frame;
+}
+
+void FrameCache::prefetch(uint64_t time, int direction, uint64_t maxTime)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    // anything still pending was queued for an older position
+    pending.clear();
+    if (!maxTasks) return;
+    auto enqueue = [&](int64_t offset)
+    {
+        if (offset < 0 && (uint64_t)(-offset) > time) return;
+        uint64_t t = time + offset;
+        if (t > maxTime || entries.count(t)) return;
+        pending.push_back(t);
+    };
+    if (direction == 0)
+    {
+        for (size_t i = 1; i <= prefetchDepth / 2; i++)
+        {
+            enqueue(i);
+            enqueue(-(int64_t)i);
+        }
+    }
+    else
+    {
+        // mostly ahead in the direction of movement, a few frames behind
+        for (size_t i = 1; i <= prefetchDepth; i++)
+        {
+            enqueue(direction * (int64_t)i);
+        }
+        for (size_t i = 1; i <= prefetchDepth / 4; i++)
+        {
+            enqueue(-direction * (int64_t)i);
+        }
+    }
+    while (runningTasks < std::min(maxTasks, pending.size()))
+    {
+        runningTasks++;
+        ThreadPool::get().submit(
+            [this]()
+            {
+                this->prefetchTask();
+            }
+        );
+    }
+}
+
+void FrameCache::prefetchTask()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    while (!stopping && !pending.empty())
+    {
+        uint64_t time = pending.front();
+        pending.pop_front();
+        if (entries.count(time)) continue;
+        Columns currColumns = columns;
+        size_t currStart = start;
+        size_t currCount = count;
+        uint64_t currGeneration = generation;
+
+        lock.unlock();
+        auto frame = decode(currColumns, currStart, currCount, time);
+        lock.lock();
+
+        // drop the frame if the window changed while decoding
+        if (currGeneration == generation) insert(time, frame);
+    }
+    if (--runningTasks == 0) tasksDone.notify_all();
+}
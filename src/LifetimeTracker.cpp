@@ -0,0 +1,252 @@
+/**
+ * Author:          Cynthia Wang
+ * Date created:    10/19/2026
+ * Organization:    ECE 4122
+ *
+ * Description:
+ * Source file for LifetimeTracker class and functions. See LifetimeTracker.hpp for function descriptions.
+*/
+
+#include "LifetimeTracker.hpp"
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <functional>
+
+#define NOT_ALLOCATED ((uint64_t)-1)
+
+// fewest indices of a var swept by one task
+#define MIN_INDICES_PER_TASK 64
+
+/**
+ * @brief Check whether a formatted value (e.g. `1`, `h0a`) is nonzero.
+ */
+static inline bool isActive(const std::string& value)
+{
+    size_t first = (!value.empty() && (value[0] == 'h' || value[0] == 'b')) ? 1 : 0;
+    return value.find_first_of("123456789abcdefABCDEF", first) != std::string::npos;
+}
+
+void LifetimeTracker::setValuesMutex(std::shared_mutex* mutex)
+{
+    valuesMutex = mutex;
+}
+
+void LifetimeTracker::sweepVar(VcdVar* var, size_t first, size_t last, uint64_t endTime, std::vector<Lifetime>& out)
+{
+    std::vector<uint64_t> since(last - first, NOT_ALLOCATED);
+    var->forEachValue(endTime,
+        [&](uint64_t start, uint64_t, const std::string& value)
+        {
+            for (size_t i = first; i < last; i++)
+            {
+                bool active = (VcdVar::bitAt(value, i) == '1');
+                uint64_t& allocated = since[i - first];
+                if (active && allocated == NOT_ALLOCATED)
+                {
+                    allocated = start;
+                }
+                else if (!active && allocated != NOT_ALLOCATED)
+                {
+                    out.push_back(Lifetime{i, allocated, start, false});
+                    allocated = NOT_ALLOCATED;
+                }
+            }
+        }
+    );
+    for (size_t i = first; i < last; i++)
+    {
+        if (since[i - first] != NOT_ALLOCATED) out.push_back(Lifetime{i, since[i - first], endTime + 1, true});
+    }
+}
+
+void LifetimeTracker::sweepElement(VcdVar* element, size_t index, uint64_t endTime, std::vector<Lifetime>& out)
+{
+    uint64_t allocated = NOT_ALLOCATED;
+    element->forEachValue(endTime,
+        [&](uint64_t start, uint64_t, const std::string& value)
+        {
+            bool active = (value.find('1') != std::string::npos);
+            if (active && allocated == NOT_ALLOCATED)
+            {
+                allocated = start;
+            }
+            else if (!active && allocated != NOT_ALLOCATED)
+            {
+                out.push_back(Lifetime{index, allocated, start, false});
+                allocated = NOT_ALLOCATED;
+            }
+        }
+    );
+    if (allocated != NOT_ALLOCATED) out.push_back(Lifetime{index, allocated, endTime + 1, true});
+}
+
+void LifetimeTracker::sweepPrimitive(VcdPrimitive* primitive, uint64_t endTime, std::vector<Lifetime>& out)
+{
+    size_t size = primitive->getSize();
+    std::vector<uint64_t> since(size, NOT_ALLOCATED);
+    uint64_t time = 0;
+    while (1)
+    {
+        std::vector<std::string> values = primitive->getValueWindow(time, 0, size);
+        for (size_t i = 0; i < size; i++)
+        {
+            bool active = isActive(values[i]);
+            if (active && since[i] == NOT_ALLOCATED)
+            {
+                since[i] = time;
+            }
+            else if (!active && since[i] != NOT_ALLOCATED)
+            {
+                out.push_back(Lifetime{i, since[i], time, false});
+                since[i] = NOT_ALLOCATED;
+            }
+        }
+        time = primitive->getNextChange(time);
+        if (time == (uint64_t)-1 || time > endTime) break;
+    }
+    for (size_t i = 0; i < size; i++)
+    {
+        if (since[i] != NOT_ALLOCATED) out.push_back(Lifetime{i, since[i], endTime + 1, true});
+    }
+}
+
+void LifetimeTracker::compute(VcdPrimitive* valid, uint64_t endTime)
+{
+    auto startTime = std::chrono::high_resolution_clock::now();
+    std::shared_lock<std::shared_mutex> lock;
+    if (valuesMutex) lock = std::shared_lock<std::shared_mutex>(*valuesMutex);
+
+    this->endTime = endTime;
+    size_t numThreads = ThreadPool::get().getThreads();
+
+    // split the sweep into tasks, each with its own output
+    std::vector<std::function<void(std::vector<Lifetime>&)>> tasks;
+    if (valid->getType() == VcdNode::VAR)
+    {
+        VcdVar* var = dynamic_cast<VcdVar*>(valid);
+        size_t size = var->getSize();
+        size_t perTask = std::max((size + numThreads - 1) / numThreads, (size_t)MIN_INDICES_PER_TASK);
+        for (size_t first = 0; first < size; first += perTask)
+        {
+            size_t last = std::min(first + perTask, size);
+            tasks.emplace_back([var, first, last, endTime](std::vector<Lifetime>& out)
+                {
+                    sweepVar(var, first, last, endTime, out);
+                }
+            );
+        }
+    }
+    else if (valid->getType() == VcdNode::ARR_SCOPE)
+    {
+        VcdArrScope* array = dynamic_cast<VcdArrScope*>(valid);
+        for (size_t i = 0; i < array->getSize(); i++)
+        {
+            VcdVar* element = array->getElement(i);
+            if (!element) continue;
+            tasks.emplace_back([element, i, endTime](std::vector<Lifetime>& out)
+                {
+                    sweepElement(element, i, endTime, out);
+                }
+            );
+        }
+    }
+    else
+    {
+        tasks.emplace_back([valid, endTime](std::vector<Lifetime>& out)
+            {
+                sweepPrimitive(valid, endTime, out);
+            }
+        );
+    }
+
+    std::vector<std::vector<Lifetime>> outs(tasks.size());
+    ThreadPool::get().parallelFor(tasks.size(),
+        [&](size_t i, size_t)
+        {
+            tasks[i](outs[i]);
+        }
+    );
+
+    lifetimes.clear();
+    lengths.clear();
+    for (auto& out : outs)
+    {
+        lifetimes.insert(lifetimes.end(), out.begin(), out.end());
+    }
+    std::stable_sort(lifetimes.begin(), lifetimes.end(),
+        [](const Lifetime& a, const Lifetime& b)
+        {
+            return a.length() > b.length() || (a.length() == b.length() && a.start < b.start);
+        }
+    );
+    for (auto& lifetime : lifetimes)
+    {
+        if (!lifetime.open) lengths.push_back(lifetime.length());
+    }
+    std::sort(lengths.begin(), lengths.end());
+
+    std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - startTime;
+    seconds = elapsed.count();
+}
+
+const std::vector<LifetimeTracker::Lifetime>& LifetimeTracker::getLifetimes()
+{
+    return lifetimes;
+}
+
+size_t LifetimeTracker::getClosedCount()
+{
+    return lengths.size();
+}
+
+uint64_t LifetimeTracker::getPercentile(double percent)
+{
+    if (lengths.empty()) return 0;
+    // nearest rank
+    size_t rank = (size_t)ceil(percent / 100.0 * lengths.size());
+    return lengths[std::min(std::max(rank, (size_t)1), lengths.size()) - 1];
+}
+
+double LifetimeTracker::getMean()
+{
+    if (lengths.empty()) return 0;
+    double sum = 0;
+    for (uint64_t length : lengths) sum += length;
+    return sum / lengths.size();
+}
+
+std::vector<std::pair<uint64_t, size_t>> LifetimeTracker::getHistogram()
+{
+    std::vector<std::pair<uint64_t, size_t>> histogram;
+    if (lengths.empty()) return histogram;
+    auto bin = [](uint64_t length)
+    {
+        size_t b = 0;
+        while (length >>= 1) b++;
+        return b;
+    };
+    size_t firstBin = bin(lengths.front());
+    size_t lastBin = bin(lengths.back());
+    for (size_t b = firstBin; b <= lastBin; b++)
+    {
+        histogram.emplace_back(1ULL << b, 0);
+    }
+    for (uint64_t length : lengths)
+    {
+        histogram[bin(length) - firstBin].second++;
+    }
+    return histogram;
+}
+
+uint64_t LifetimeTracker::getEndTime()
+{
+    return endTime;
+}
+
+double LifetimeTracker::getSeconds()
+{
+    return seconds;
+}
@@ -0,0 +1,136 @@
+/**
+ * Author:          Cynthia Wang
+ * Date created:    10/19/2026
+ * Organization:    ECE 4122
+ *
+ * Description:
+ * Source file for LoadStats class and functions. See LoadStats.hpp for function descriptions.
+*/
+
+#include "LoadStats.hpp"
+
+#include <sys/resource.h>
+#include <time.h>
+#include <algorithm>
+#include <cstdio>
+#include <sstream>
+
+#include "Trace.hpp"
+
+LoadStats::LoadStats()
+    : phaseCpuStart(0), phaseTraceStart(0), files(0), bytes(0), valueChanges(0), vars(0), aliases(0), scopes(0),
+      arrays(0), intervalSeconds(0)
+{}
+
+double LoadStats::cpuSeconds()
+{
+    timespec ts;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+uint64_t LoadStats::peakRssBytes()
+{
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+    return usage.ru_maxrss;
+#else
+    return (uint64_t)usage.ru_maxrss * 1024; // in KB on Linux
+#endif
+}
+
+void LoadStats::beginPhase(const std::string& name)
+{
+    endPhase();
+    phaseName = name;
+    phaseStart = std::chrono::steady_clock::now();
+    phaseCpuStart = cpuSeconds();
+    phaseTraceStart = Trace::now();
+}
+
+void LoadStats::endPhase()
+{
+    if (phaseName.empty()) return;
+    double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - phaseStart).count();
+    phases.push_back(Phase{phaseName, wall, cpuSeconds() - phaseCpuStart});
+    Trace::complete(phaseName, "parse", phaseTraceStart, Trace::now() - phaseTraceStart);
+    phaseName.clear();
+}
+
+void LoadStats::reserveThreads(size_t count)
+{
+    if (threadWork.size() < count) threadWork.resize(count, ThreadWork{0, 0, 0});
+}
+
+void LoadStats::addThreadWork(size_t thread, uint64_t vars, uint64_t changes, double seconds)
+{
+    threadWork[thread].vars += vars;
+    threadWork[thread].changes += changes;
+    threadWork[thread].seconds += seconds;
+}
+
+double LoadStats::getWallSeconds()
+{
+    double seconds = 0;
+    for (auto& phase : phases)
+    {
+        seconds += phase.wallSeconds;
+    }
+    return seconds;
+}
+
+std::vector<std::string> LoadStats::summary()
+{
+    std::vector<std::string> lines;
+    char line[256];
+    std::string phaseLine = "Phases:";
+    for (auto& phase : phases)
+    {
+        snprintf(line, sizeof(line), " %s %.3f s (CPU %.3f s)", phase.name.c_str(), phase.wallSeconds,
+            phase.cpuSeconds);
+        phaseLine += line;
+    }
+    lines.push_back(phaseLine);
+
+    double wall = getWallSeconds();
+    snprintf(line, sizeof(line), "Read %.1f MB in %llu files at %.1f MB/s: %llu value changes, %llu vars (%llu aliases), %llu scopes",
+        bytes / 1e6, (unsigned long long)files, wall ? bytes / 1e6 / wall : 0, (unsigned long long)valueChanges,
+        (unsigned long long)vars, (unsigned long long)aliases, (unsigned long long)scopes);
+    lines.push_back(line);
+
+    if (!threadWork.empty())
+    {
+        auto busiest = std::minmax_element(threadWork.begin(), threadWork.end(),
+            [](const ThreadWork& a, const ThreadWork& b) { return a.seconds < b.seconds; });
+        snprintf(line, sizeof(line), "Value intervals: %.3f s on %zu threads, busy %.3f to %.3f s each",
+            intervalSeconds, threadWork.size(), busiest.first->seconds, busiest.second->seconds);
+        lines.push_back(line);
+    }
+    snprintf(line, sizeof(line), "Peak RSS: %.1f MB", peakRssBytes() / 1e6);
+    lines.push_back(line);
+    return lines;
+}
+
+std::string LoadStats::toJson()
+{
+    std::ostringstream ss;
+    double wall = getWallSeconds();
+    ss << "{\n  \"wallSeconds\": " << wall << ",\n  \"phases\": [\n";
+    for (size_t i = 0; i < phases.size(); i++)
+    {
+        ss << "    {\"name\": \"" << phases[i].name << "\", \"wallSeconds\": " << phases[i].wallSeconds
+            << ", \"cpuSeconds\": " << phases[i].cpuSeconds << "}" << ((i + 1 < phases.size()) ? "," : "") << "\n";
+    }
+    ss << "  ],\n  \"files\": " << files << ",\n  \"bytes\": " << bytes << ",\n  \"mbPerSecond\": "
+        << (wall ? bytes / 1e6 / wall : 0) << ",\n  \"valueChanges\": " << valueChanges << ",\n  \"vars\": " << vars
+        << ",\n  \"aliases\": " << aliases << ",\n  \"scopes\": " << scopes << ",\n  \"arrays\": " << arrays << ",\n  \"intervalSeconds\": "
+        << intervalSeconds << ",\n  \"threads\": [\n";
+    for (size_t i = 0; i < threadWork.size(); i++)
+    {
+        ss << "    {\"vars\": " << threadWork[i].vars << ", \"changes\": " << threadWork[i].changes
+            << ", \"seconds\": " << threadWork[i].seconds << "}" << ((i + 1 < threadWork.size()) ? "," : "") << "\n";
+    }
+    ss << "  ],\n  \"peakRssBytes\": " << peakRssBytes() << "\n}\n";
+    return ss.str();
+}
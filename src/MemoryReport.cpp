@@ -0,0 +1,137 @@
+/**
+ * Author:          Cynthia Wang
+ * Date created:    10/19/2026
+ * Organization:    ECE 4122
+ *
+ * Description:
+ * Source file for MemoryReport class and functions. See MemoryReport.hpp for function descriptions.
+*/
+
+#include "MemoryReport.hpp"
+
+#include <algorithm>
+#include <cstdio>
+
+#include "Vcd.hpp"
+
+MemoryReport::MemoryReport(SignalIndex& index, ValueTable& values, size_t count)
+    : total{"", 0, 0, 0, 0}, internedValues(values.size()), internedBytes(values.getMemoryBytes())
+{
+    // the values themselves are counted in the vars that added them
+    total.valueBytes = values.getOverheadBytes();
+
+    // usage of each entry by id
+    std::vector<Counts> counts(index.size(), Counts{0, 0, 0, 0});
+    std::vector<SignalIndex::Id> varIds, scopeIds;
+    for (SignalIndex::Id id = 0; id < index.size(); id++)
+    {
+        VcdNode* node = index.getNode(id);
+        Counts& usage = counts[id];
+        usage.indexBytes = index.getEntryBytes(id);
+        total.indexBytes += usage.indexBytes;
+        if (node->getType() != VcdNode::VAR)
+        {
+            scopeIds.push_back(id);
+            continue;
+        }
+        VcdVar* var = dynamic_cast<VcdVar*>(node);
+        usage.vars = 1;
+        usage.changes = var->getChangeCount();
+        usage.valueBytes = var->getMemoryBytes();
+        total.vars++;
+        total.changes += usage.changes;
+        total.valueBytes += usage.valueBytes;
+        varIds.push_back(id);
+    }
+
+    // a scope comes before everything under it in id order, so going
+    // backwards adds each entry to its scope once the entry is complete
+    for (SignalIndex::Id id = index.size(); id-- > 0;)
+    {
+        SignalIndex::Id parent = index.getParent(id);
+        if (parent == SignalIndex::NONE) continue;
+        counts[parent].vars += counts[id].vars;
+        counts[parent].changes += counts[id].changes;
+        counts[parent].valueBytes += counts[id].valueBytes;
+        counts[parent].indexBytes += counts[id].indexBytes;
+    }
+
+    selectRows(index, counts, varIds, count, vars);
+    selectRows(index, counts, scopeIds, count, scopes);
+}
+
+void MemoryReport::selectRows(SignalIndex& index, const std::vector<Counts>& counts, std::vector<SignalIndex::Id>& ids,
+    size_t count, std::vector<Usage>& rows)
+{
+    // heaviest first, and in id order among equals
+    auto heavier = [&counts](SignalIndex::Id a, SignalIndex::Id b)
+    {
+        uint64_t bytesA = counts[a].valueBytes + counts[a].indexBytes;
+        uint64_t bytesB = counts[b].valueBytes + counts[b].indexBytes;
+        return (bytesA != bytesB) ? bytesA > bytesB : a < b;
+    };
+    count = std::min(count, ids.size());
+    std::partial_sort(ids.begin(), ids.begin() + count, ids.end(), heavier);
+    for (size_t i = 0; i < count; i++)
+    {
+        const Counts& usage = counts[ids[i]];
+        rows.push_back(Usage{index.getPath(ids[i]), usage.vars, usage.changes, usage.valueBytes, usage.indexBytes});
+    }
+}
+
+const std::vector<MemoryReport::Usage>& MemoryReport::getVars()
+{
+    return vars;
+}
+
+const std::vector<MemoryReport::Usage>& MemoryReport::getScopes()
+{
+    return scopes;
+}
+
+const MemoryReport::Usage& MemoryReport::getTotal()
+{
+    return total;
+}
+
+std::string MemoryReport::formatBytes(uint64_t bytes)
+{
+    char str[32];
+    if (bytes >= 1000000000)
+        snprintf(str, sizeof(str), "%.1f GB", bytes / 1e9);
+    else if (bytes >= 1000000)
+        snprintf(str, sizeof(str), "%.1f MB", bytes / 1e6);
+    else if (bytes >= 1000)
+        snprintf(str, sizeof(str), "%.1f KB", bytes / 1e3);
+    else
+        snprintf(str, sizeof(str), "%llu B", (unsigned long long)bytes);
+    return str;
+}
+
+void MemoryReport::formatRows(const std::vector<Usage>& rows, uint64_t totalBytes, std::vector<std::string>& lines)
+{
+    char line[64];
+    snprintf(line, sizeof(line), "%10s %10s %10s %6s  ", "values", "index", "changes", "share");
+    lines.push_back(std::string(line) + "name");
+    for (auto& row : rows)
+    {
+        snprintf(line, sizeof(line), "%10s %10s %10llu %5.1f%%  ", formatBytes(row.valueBytes).c_str(),
+            formatBytes(row.indexBytes).c_str(), (unsigned long long)row.changes,
+            100.0 * row.getBytes() / std::max(totalBytes, (uint64_t)1));
+        lines.push_back(std::string(line) + row.path);
+    }
+}
+
+std::vector<std::string> MemoryReport::format()
+{
+    std::vector<std::string> lines;
+    lines.push_back("Memory of " + std::to_string(total.vars) + " vars: " + formatBytes(total.valueBytes)
+        + " of values, " + formatBytes(total.indexBytes) + " of index, " + std::to_string(total.changes) + " changes");
+    lines.push_back("Interned values: " + std::to_string(internedValues) + " distinct values of vectors in "
+        + formatBytes(internedBytes) + ", each counted in the var that first stored it");
+    lines.push_back("Heaviest signals:");
+    formatRows(vars, total.getBytes(), lines);
+    lines.push_back("Heaviest scopes:");
+    formatRows(scopes, total.getBytes(), lines);
+    return lines;
+}
@@ -8,43 +8,104 @@
 */
 
 #include "Parser.hpp"
+#include "MemoryReport.hpp"
+#include "ThreadPool.hpp"
+#include "Trace.hpp"
 
 #include <unistd.h>
 
 #include <boost/algorithm/string.hpp>
+#include <algorithm>
 #include <fstream>
 #include <iostream>
 #include <sstream>
-#include <thread>
-#include <ncurses.h>
+#include <unordered_map>
+#include <unordered_set>
 #include <regex>
 
-#if USE_OMP
-#include <omp.h>
-#endif
+// publish parsed values at most this often so readers are not starved
+#define PUBLISH_BYTES (1 << 20)
+#define PUBLISH_INTERVAL std::chrono::milliseconds(250)
+
+Parser::Parser(std::vector<std::string> filenames)
+    : filename(filenames.at(0)), topScope(nullptr), currState(PARSE_NONE), currTime(0), maxTime(0),
+      totalBytes(0), bytesRead(0), definitionsDone(false), done(false), frontier(0),
+      parseStartTime(std::chrono::high_resolution_clock::now()), intervalTime(0), timeHasDeltas(false), publishing(true)
+{
+    for (size_t i = 1; i < filenames.size(); i++) 
+    {
+        shards.emplace_back(new Parser(filenames[i]));
+        shards.back()->publishing = false;
+    }
+}
 
 void Parser::parse() 
 {
-    // Determine the number of threads that can run concurrently
-    uint64_t numThreads = std::thread::hardware_concurrency();
-    printw("Your computer supports %llu concurrent threads.\n\r", numThreads);
-#ifdef USE_OMP
-    printw("Using OpenMP.\n\r", numThreads);
-#endif
-    refresh();
+    addReport("Using " + std::to_string(ThreadPool::get().getThreads()) + " threads.");
 
-    std::ifstream infile(filename);
+    stats.beginPhase("header");
+    std::vector<std::future<void>> shardsParsed;
+    if (!shards.empty()) startShards(shardsParsed);
+
+    startMeasureTime("Parsing...");
+    parseFile();
+    stats.beginPhase("post-processing");
+    publishValues(maxTime);
+    mergeShards(shardsParsed);
+    stats.endPhase();
+
+    endMeasureTime("Parse Time (including value intervals)");
+    addReport("Value Interval Processing Time: " + std::to_string(intervalTime) + " us");
+
+    stats.files = shards.size() + 1;
+    stats.bytes = totalBytes;
+    for (auto& shard : shards) 
+    {
+        stats.bytes += shard->totalBytes;
+    }
+    stats.vars = varHashes.size();
+    stats.aliases = aliases.size();
+    // scopes reopened by a later $scope are merged into the first one, so
+    // count the distinct scopes in the index
+    stats.scopes = 0;
+    for (SignalIndex::Id id = 0; id < index.size(); id++) 
+    {
+        if (index.getNode(id)->getType() != VcdNode::VAR) stats.scopes++;
+    }
+    stats.arrays = arrScopes.size();
+    stats.intervalSeconds = intervalTime / 1e6;
+    addReport("");
+    for (auto& line : stats.summary()) 
+    {
+        addReport(line);
+    }
+    addReport("");
+    for (auto& line : MemoryReport(index, valueTable, 3).format()) 
+    {
+        addReport(line);
+    }
+    done = true;
+}
+
+void Parser::parseFile() 
+{
+    std::ifstream infile(filename, std::ios::binary | std::ios::ate);
+    totalBytes = infile.tellg();
+    infile.seekg(0);
     std::string line;
     VcdScope* currScope = nullptr;
     std::string token;
+    uint64_t bytes = 0;
+    uint64_t lastPublishBytes = 0;
+    auto lastPublishTime = parseStartTime;
 
     std::regex unpackedVecRegex("^.+\\[[0-9]+\\]$");
 
-    startMeasureTime("Parsing...");
-
     // read in line by line
     while (std::getline(infile, line)) 
     {
+        bytes += line.size() + 1;
+        bytesRead.store(bytes, std::memory_order_relaxed);
         boost::algorithm::trim(line);
         if (line.empty()) continue;
 
@@ -61,6 +122,12 @@ void Parser::parse()
                     currScope = currScope->parent;
                     break;
                 }
+                if (currState == PARSE_VALUES && !definitionsDone) 
+                {
+                    stats.beginPhase("values");
+                    finishDefinitions();
+                    if (publishing) index.buildTrigrams();
+                }
             } 
             else 
             {
@@ -121,27 +188,47 @@ void Parser::parse()
                         std::string name = token;
                         ss >> token;
                         std::string dimensions = token;
+                        bool unpacked = std::regex_match(name, unpackedVecRegex);
+                        // the array of an element, if declared before in this scope
+                        std::string scopeName = unpacked ? name.substr(0, name.find("[")) : "";
+                        VcdArrScope* arrScope = nullptr;
+                        if (unpacked) 
+                        {
+                            auto arr = currScope->children.find(scopeName);
+                            if (arr != currScope->children.end() && arr->second->getType() == VcdNode::ARR_SCOPE) 
+                                arrScope = dynamic_cast<VcdArrScope*>(arr->second);
+                        }
+                        VcdVar* curr_var;
                         if (!varMap.count(hash)) 
                         {
-                            VcdVar* curr_var = new VcdVar();
-                            curr_var->parent = currScope;
+                            curr_var = new VcdVar();
                             curr_var->size = size;
-                            curr_var->hash = hash;
-                            curr_var->name = name;
-                            curr_var->dimensions = dimensions;
+                            curr_var->valueKind = VcdVar::kindOfType(type);
+                            curr_var->store = std::make_shared<VcdStore>(size, curr_var->valueKind, &valueTable);
                             varMap[hash] = curr_var;
                             varHashes.push_back(hash);
                         }
-                        if (std::regex_match(name, unpackedVecRegex)) 
+                        else 
+                        {
+                            // another name for the values of an earlier var, e.g. a port
+                            // connected through the hierarchy, unless it is declared again
+                            // in a scope visited before
+                            VcdScope* scope = unpacked ? arrScope : currScope;
+                            VcdVar* existing = nullptr;
+                            if (scope && scope->children.count(name)) 
+                                existing = dynamic_cast<VcdVar*>(scope->children[name]);
+                            if (existing && existing->getStore() == varMap[hash]->getStore()) break;
+                            curr_var = new VcdAlias(varMap[hash]);
+                            aliases.push_back(curr_var);
+                        }
+                        curr_var->parent = currScope;
+                        curr_var->hash = hash;
+                        curr_var->name = name;
+                        curr_var->dimensions = dimensions;
+                        if (unpacked) 
                         { 
-                            // unpacked array, extract name to use as scope
-                            std::string scopeName = name.substr(0, name.find("["));
-                            VcdScope* arrScope;
-                            if (arrScopes.count(scopeName)) 
-                            {
-                                arrScope = arrScopes[scopeName];
-                            }
-                            else 
+                            // unpacked array, named like the element without its index
+                            if (!arrScope) 
                             {
                                 arrScope = new VcdArrScope();
                                 arrScope->name = scopeName;
@@ -149,14 +236,19 @@ void Parser::parse()
                                 arrScope->type = VcdNode::ARR_SCOPE;
                                 currScope->children[scopeName] = arrScope;
                                 scopes.emplace_back(arrScope);
-                                arrScopes[scopeName] = arrScope;
+                                arrScopes.push_back(arrScope);
                             }
-                            varMap[hash]->parent = arrScope;
-                            arrScope->children[varMap[hash]->name] = varMap[hash];
+                            curr_var->parent = arrScope;
+                            arrScope->children[name] = curr_var;
+                            // keep elements ordered by index for windowed access
+                            size_t arrIdx = std::stoul(name.substr(scopeName.size() + 1));
+                            if (arrIdx >= arrScope->elements.size()) 
+                                arrScope->elements.resize(arrIdx + 1, nullptr);
+                            arrScope->elements[arrIdx] = curr_var;
                         } 
                         else 
                         {
-                            currScope->children[varMap[hash]->name] = varMap[hash];
+                            currScope->children[name] = curr_var;
                         }
                         break;
                     }
@@ -164,20 +256,48 @@ void Parser::parse()
                     {
                         if (token.at(0) == '#') 
                         {
-                            currTime = stoi(token.substr(1, token.size()));
+                            uint64_t nextTime = std::stoull(token.substr(1, token.size()));
+                            if (timeHasDeltas) recordDeltas();
+                            timeChanges.clear();
+                            // everything before nextTime is known, so it can be published
+                            if (publishing && bytes - lastPublishBytes >= PUBLISH_BYTES && nextTime > 0) 
+                            {
+                                lastPublishBytes = bytes;
+                                auto now = std::chrono::high_resolution_clock::now();
+                                if (now - lastPublishTime >= PUBLISH_INTERVAL) 
+                                {
+                                    publishValues(nextTime - 1);
+                                    lastPublishTime = now;
+                                }
+                            }
+                            currTime = nextTime;
                         } 
-                        else if (token.at(0) == 'b') 
+                        else if (token.at(0) == 'b' || token.at(0) == 'r' || token.at(0) == 'R' || token.at(0) == 's'
+                              || token.at(0) == 'S') 
                         {
+                            // vector, real or string value, followed by the identifier
                             std::string value = token;
                             ss >> token;
-                            varMap[token]->vcdValues.emplace_back(
+                            VcdVar* var = varMap[token];
+                            // a 1-bit var stores the bit only, as if it were dumped as a scalar
+                            if (var->size == 1 && var->valueKind == VcdVar::VECTOR) value.erase(0, value.size() - 1);
+                            if (!var->store->vcdValues.empty() && var->store->vcdValues.back().first == currTime) 
+                                timeHasDeltas = true;
+                            var->store->vcdValues.emplace_back(
                                 std::pair(currTime, value));
+                            timeChanges.push_back(var);
+                            stats.valueChanges++;
                         } 
                         else 
                         {
                             std::string hash = token.substr(1, token.size());
-                            varMap[hash]->vcdValues.emplace_back(
+                            VcdVar* var = varMap[hash];
+                            if (!var->store->vcdValues.empty() && var->store->vcdValues.back().first == currTime) 
+                                timeHasDeltas = true;
+                            var->store->vcdValues.emplace_back(
                                 std::pair(currTime, token.substr(0, 1)));
+                            timeChanges.push_back(var);
+                            stats.valueChanges++;
                         }
                         break;
                     }
@@ -187,99 +307,248 @@ void Parser::parse()
             }
         }
     }
+    if (timeHasDeltas) recordDeltas();
+    timeChanges.clear();
+    if (!definitionsDone) 
+    {
+        finishDefinitions();
+        if (publishing) index.buildTrigrams();
+    }
     maxTime = currTime;
-    if (!version.empty()) version = version.substr(1, version.size());
-    if (!timescale.empty()) timescale = timescale.substr(1, timescale.size());
-    if (!date.empty()) date = date.substr(1, date.size());
+}
 
-    endMeasureTime("Parse Time");
-    
-    startMeasureTime("Processing data into value intervals...");
+void Parser::recordDeltas() 
+{
+    // the changes of each var at currTime are the last of its pending
+    // changes; next holds the pending change of each var for its next event
+    std::unordered_map<VcdVar*, std::list<std::pair<uint64_t, std::string>>::iterator> next;
+    std::vector<DeltaEvent> events;
+    events.reserve(timeChanges.size());
+    for (VcdVar* var : timeChanges) 
+    {
+        auto it = next.find(var);
+        std::string previous;
+        if (it == next.end()) 
+        {
+            auto first = var->store->vcdValues.end();
+            while (first != var->store->vcdValues.begin() && std::prev(first)->first == currTime) 
+            {
+                --first;
+            }
+            if (first != var->store->vcdValues.begin()) 
+                previous = std::prev(first)->second;
+            else if (currTime > 0) 
+                previous = var->valueAt(currTime - 1);
+            else 
+                previous = (var->size > 1 && var->valueKind == VcdVar::VECTOR) ? "bx" : "x";
+            it = next.emplace(var, first).first;
+        }
+        else 
+        {
+            previous = std::prev(it->second)->second;
+        }
+        events.push_back(DeltaEvent{var, it->second->second, previous});
+        ++it->second;
+    }
+    std::unique_lock<std::shared_mutex> lock(valuesMutex);
+    deltaEvents[currTime] = std::move(events);
+    timeHasDeltas = false;
+}
 
-#ifdef USE_OMP
-    constructValueIntervals();
-#else
-    std::list<std::thread> threads;
-    uint64_t numVars = varHashes.size();
-    uint64_t varsPerThread = floor((numVars) / (double) (numThreads - 1)); // min # vars each thread should have
-    uint64_t remainder = numVars % (numThreads - 1);
-    uint64_t i = 0;
-    // Create the threads (max n-1) and distribute responsibility among the threads
-    while (threads.size() < (numThreads - 1)) 
+void Parser::startShards(std::vector<std::future<void>>& parsed) 
+{
+    // order the files by their first timestamp, since names like run.10.vcd
+    // do not sort in time order, and take the first one
+    uint64_t startTime = firstTimestamp(filename);
+    for (size_t i = 0; i < shards.size(); i++) 
     {
-        uint64_t end = threads.size() >= remainder ? i + varsPerThread : i + varsPerThread + 1;
-        threads.emplace_back(
-            std::thread(
-                [this, start = i, end]() 
-                {
-                    this->constructValueIntervals(start, end);
-                }
-            )
+        shardStartTimes.push_back(firstTimestamp(shards[i]->filename));
+        if (shardStartTimes[i] < startTime) 
+        {
+            std::swap(filename, shards[i]->filename);
+            std::swap(startTime, shardStartTimes[i]);
+        }
+        shardOrder.push_back(i);
+    }
+    std::stable_sort(shardOrder.begin(), shardOrder.end(),
+        [this](size_t a, size_t b) 
+        {
+            return shardStartTimes[a] < shardStartTimes[b];
+        }
+    );
+
+    addReport("Parsing " + std::to_string(shards.size() + 1) + " files of a split dump concurrently.");
+    for (auto& shard : shards) 
+    {
+        auto task = std::make_shared<std::packaged_task<void()>>(
+            [shard = shard.get()]() 
+            {
+                Trace::Span span("parseFile (shard)", "parse");
+                shard->parseFile();
+            }
         );
-        i = end;
+        parsed.push_back(task->get_future());
+        ThreadPool::get().submit([task]() { (*task)(); });
     }
+}
 
-    // wait for threads to finish
-    for (auto& thread : threads) 
+void Parser::mergeShards(std::vector<std::future<void>>& parsed) 
+{
+    for (size_t i : shardOrder) 
     {
-        thread.join();
+        parsed[i].wait();
+        Trace::Span span("mergeShard", "parse");
+        Parser& shard = *shards[i];
+        std::string reason = checkShard(shard);
+        if (reason.empty() && shardStartTimes[i] < currTime) 
+            reason = "overlaps the previous file";
+        if (!reason.empty()) 
+        {
+            addReport("Skipped " + shard.filename + ": " + reason + ".");
+            continue;
+        }
+
+        // move the delta events of the shard to the vars of this parser; the
+        // first change of a var in the shard, whenever it comes, follows its
+        // last change so far, which the shard could not know
+        std::unordered_set<VcdVar*> seen;
+        for (auto& [time, events] : shard.deltaEvents) 
+        {
+            for (auto& event : events) 
+            {
+                VcdVar* var = varMap[event.var->hash];
+                if (seen.insert(var).second && event.var->store->vcdValues.front().first == time) 
+                    event.previous = var->valueAt(currTime);
+                event.var = var;
+            }
+            // a shard may start at the last time of the previous file
+            std::unique_lock<std::shared_mutex> lock(valuesMutex);
+            std::vector<DeltaEvent>& merged = deltaEvents[time];
+            merged.insert(merged.end(), std::make_move_iterator(events.begin()), std::make_move_iterator(events.end()));
+        }
+
+        // append the pending changes of the shard, which come after all
+        // of the changes so far
+        for (auto& hash : varHashes) 
+        {
+            std::list<std::pair<uint64_t, std::string>>& values = varMap[hash]->store->vcdValues;
+            values.splice(values.end(), shard.varMap[hash]->store->vcdValues);
+        }
+        stats.valueChanges += shard.stats.valueChanges;
+        currTime = shard.currTime;
+        maxTime = currTime;
+        publishValues(maxTime);
     }
-#endif
-    endMeasureTime("Value Interval Processing Time");
-
-    printw(
-        "\n\r"
-        "Version:   %s\n\r"
-        "Date:      %s\n\r"
-        "Timescale: %s\n\r"
-        "Top scope: %s\n\r",
-        version.c_str(),
-        date.c_str(),
-        timescale.c_str(),
-        topScope->name.c_str()
-    );
-    refresh();
+}
+
+std::string Parser::checkShard(Parser& shard) 
+{
+    if (shard.timescale != timescale) 
+        return "timescale " + shard.timescale + " differs from " + timescale;
+    if (shard.varHashes.size() != varHashes.size()) 
+        return "declares " + std::to_string(shard.varHashes.size()) + " vars instead of " + std::to_string(varHashes.size());
+    for (auto& hash : varHashes) 
+    {
+        auto it = shard.varMap.find(hash);
+        if (it == shard.varMap.end() || it->second->name != varMap[hash]->name || it->second->size != varMap[hash]->size
+         || it->second->valueKind != varMap[hash]->valueKind) 
+            return "declaration of " + varMap[hash]->name + " differs";
+    }
+    return "";
+}
+
+uint64_t Parser::firstTimestamp(const std::string& filename) 
+{
+    std::ifstream infile(filename);
+    std::string line;
+    bool values = false;
+    while (std::getline(infile, line)) 
+    {
+        boost::algorithm::trim(line);
+        if (!values) 
+            values = (line.find("$enddefinitions") != std::string::npos);
+        else if (!line.empty() && line.at(0) == '#') 
+            return std::stoull(line.substr(1, line.size()));
+    }
+    return 0;
+}
+
+void Parser::finishDefinitions() 
+{
+    if (!version.empty()) version = version.substr(1, version.size());
+    if (!timescale.empty()) timescale = timescale.substr(1, timescale.size());
+    if (!date.empty()) date = date.substr(1, date.size());
 
+    addReport("");
+    addReport("Version:   " + version);
+    addReport("Date:      " + date);
+    addReport("Timescale: " + timescale);
+    addReport("Top scope: " + (topScope ? topScope->name : std::string()));
+    addReport("");
+
+    // the vars of a shard are only looked up by identifier code when merged
+    if (publishing) index.build(topScope);
+    definitionsDone = true;
 }
 
-#ifdef USE_OMP
-void Parser::constructValueIntervals() 
+void Parser::publishValues(uint64_t newFrontier) 
 {
-    constructValueIntervals(0, varHashes.size());
+    Trace::Span span("publishValues", "parse");
+    auto start = std::chrono::high_resolution_clock::now();
+    std::unique_lock<std::shared_mutex> lock(valuesMutex);
+
+    // split the vars into a few chunks per thread, so a thread busy with
+    // other work delays the rest little
+    ThreadPool& pool = ThreadPool::get();
+    uint64_t numVars = varHashes.size();
+    uint64_t numChunks = std::min(numVars, (uint64_t)pool.getThreads() * 4);
+    stats.reserveThreads(pool.getThreads());
+    pool.parallelFor(numChunks,
+        [this, numVars, numChunks](size_t chunk, size_t slot) 
+        {
+            Trace::Span span("constructValueIntervals", "parse");
+            this->constructValueIntervals(numVars * chunk / numChunks, numVars * (chunk + 1) / numChunks, slot);
+        }
+    );
+    frontier = newFrontier;
+    intervalTime += std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::high_resolution_clock::now() - start).count();
 }
-#endif
 
-void Parser::constructValueIntervals(uint64_t startIdx, uint64_t endIdx) 
+void Parser::constructValueIntervals(uint64_t startIdx, uint64_t endIdx, size_t thread) 
 {
-#ifdef USE_OMP
-#pragma omp parallel for
-#endif
+    auto start = std::chrono::steady_clock::now();
+    uint64_t vars = 0, changes = 0;
     for (uint64_t i = startIdx; i < endIdx; i++) 
     {
         std::string hash = varHashes[i];
-        VcdVar* var = varMap[hash];
-        auto it = var->vcdValues.begin();
-        uint64_t prevTimestamp = it->first;
-        std::string prevValue = it->second;
-        ++it;
-        for (; it != var->vcdValues.end(); ++it) 
+        VcdStore* store = varMap[hash]->getStore();
+        if (store->vcdValues.empty()) continue;
+        vars++;
+        changes += store->vcdValues.size();
+        for (auto it = store->vcdValues.begin(); it != store->vcdValues.end(); ++it) 
         {
-            var->intervalValues +=
-                std::make_pair(
-                    boost::icl::interval<uint64_t>::right_open(
-                        prevTimestamp, it->first
-                    ),
-                    prevValue);
-            prevTimestamp = it->first;
-            prevValue = it->second;
+            // only the last of several changes at the same time counts, and
+            // only if it changes the value, so no time is reported as a change
+            // when nothing changed
+            auto next = std::next(it);
+            if (next != store->vcdValues.end() && next->first == it->first) continue;
+            if (store->valueKind != VcdVar::VECTOR) 
+            {
+                store->appendTypedValue(it->first, it->second);
+                continue;
+            }
+            if (store->hasLastValue && it->second == store->lastValue.second) continue;
+            // a change at the time of the last value replaces it
+            if (store->hasLastValue && it->first > store->lastValue.first) 
+                store->appendTransition(store->lastValue.first, store->lastValue.second);
+            store->lastValue = *it;
+            store->hasLastValue = true;
         }
-        var->intervalValues +=
-            std::make_pair(
-                boost::icl::interval<uint64_t>::right_open(
-                    prevTimestamp, maxTime + 1
-                ),       
-                prevValue);
+        store->vcdValues.clear();
     }
+    stats.addThreadWork(thread, vars, changes,
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
 }
 
 Parser::~Parser() 
@@ -294,6 +563,10 @@ Parser::~Parser()
     {
         delete x.second;
     }
+    for (auto& alias : aliases) 
+    {
+        delete alias;
+    }
 }
 
 inline Parser::State Parser::getParseState(std::string token) 
@@ -319,48 +592,125 @@ VcdScope* Parser::getTop()
     return topScope;
 }
 
+SignalIndex& Parser::getIndex() 
+{
+    return index;
+}
+
 VcdVar* Parser::getVcdVar(std::string hierarchicalName, VcdScope* scope) 
 {
-    size_t pos = hierarchicalName.find('.');
-    std::string token;
-    VcdScope* currScope = scope;
-    token = hierarchicalName.substr(0, pos);
-    assert(currScope->name == token);
-    hierarchicalName.erase(0, pos + 1);
-    while ((pos = hierarchicalName.find('.')) != std::string::npos) 
+    // hierarchicalName starts with the name of scope, so prefix it with the
+    // names of the scopes above
+    for (VcdScope* currScope = scope->parent; currScope; currScope = currScope->parent) 
     {
-        token = hierarchicalName.substr(0, pos);
-        currScope = dynamic_cast<VcdScope*>(currScope->children[token]);
-        hierarchicalName.erase(0, pos + 1);
+        hierarchicalName = currScope->name + '.' + hierarchicalName;
     }
-    return dynamic_cast<VcdVar*>(currScope->children[hierarchicalName]);
+    return getVcdVar(hierarchicalName);
 }
 
 VcdVar* Parser::getVcdVar(std::string hierarchicalName) 
 {
-    return getVcdVar(hierarchicalName, topScope);
+    return dynamic_cast<VcdVar*>(index.find(hierarchicalName));
+}
+
+void Parser::addReport(std::string line) 
+{
+    std::lock_guard<std::mutex> lock(reportMutex);
+    report.push_back(line);
 }
 
 void Parser::startMeasureTime(const char* message) 
 {
     startTime = std::chrono::high_resolution_clock::now();
-    printw("%s\n\r", message);
-    refresh();
+    addReport(message);
 }
 
 void Parser::endMeasureTime(const char* desc) 
 {
     auto elapsed = std::chrono::high_resolution_clock::now() - startTime;
-    printw("%s: %llu us\n\r", desc, std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count());
-    refresh();
+    addReport(std::string(desc) + ": " 
+        + std::to_string(std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count()) + " us");
+}
+
+LoadStats& Parser::getStats() 
+{
+    return stats;
+}
+
+ValueTable& Parser::getValueTable() 
+{
+    return valueTable;
+}
+
+bool Parser::isDefinitionsDone() 
+{
+    return definitionsDone;
+}
+
+bool Parser::isDone() 
+{
+    return done;
+}
+
+uint64_t Parser::getBytesRead() 
+{
+    uint64_t bytes = bytesRead.load(std::memory_order_relaxed);
+    for (auto& shard : shards) 
+    {
+        bytes += shard->getBytesRead();
+    }
+    return bytes;
+}
+
+uint64_t Parser::getTotalBytes() 
+{
+    uint64_t bytes = totalBytes;
+    for (auto& shard : shards) 
+    {
+        bytes += shard->getTotalBytes();
+    }
+    return bytes;
+}
+
+double Parser::getParseSeconds() 
+{
+    std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - parseStartTime;
+    return elapsed.count();
+}
+
+std::vector<std::string> Parser::getReport() 
+{
+    std::lock_guard<std::mutex> lock(reportMutex);
+    return report;
+}
+
+std::shared_mutex& Parser::getValuesMutex() 
+{
+    return valuesMutex;
 }
 
 size_t Parser::getMaxTime() 
 {
-    return maxTime;
+    return frontier;
 }
 
 std::string Parser::getTimescale() 
 {
     return timescale;
+}
+
+std::vector<DeltaEvent> Parser::getDeltaEvents(uint64_t time) 
+{
+    std::shared_lock<std::shared_mutex> lock(valuesMutex);
+    auto it = deltaEvents.find(time);
+    if (it == deltaEvents.end() || time > frontier) return {};
+    return it->second;
+}
+
+uint64_t Parser::getNextDeltaTime(uint64_t time) 
+{
+    std::shared_lock<std::shared_mutex> lock(valuesMutex);
+    auto it = deltaEvents.upper_bound(time);
+    if (it == deltaEvents.end() || it->first > frontier) return UINT64_MAX;
+    return it->first;
 }
\ No newline at end of file
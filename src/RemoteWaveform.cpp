@@ -0,0 +1,321 @@
+/**
+ * Author:          Cynthia Wang
+ * Date created:    10/19/2026
+ * Organization:    ECE 4122
+ *
+ * Description:
+ * Source file for RemoteWaveform class and functions. See RemoteWaveform.hpp for function descriptions.
+*/
+
+#include "RemoteWaveform.hpp"
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+
+#include <boost/algorithm/string.hpp>
+
+#define NO_CHANGE ((uint64_t)-1)
+
+const std::string RemoteVar::valueAt(uint64_t time)
+{
+    std::vector<std::string> fields;
+    if (!remote->request("VALUE\t" + std::to_string(id) + '\t' + std::to_string(time), fields) || fields.empty())
+        return (getSize() > 1) ? "bx" : "x";
+    return fields[0];
+}
+
+uint64_t RemoteVar::getNextChange(uint64_t time)
+{
+    std::vector<std::string> fields;
+    if (!remote->request("NEXT\t" + std::to_string(id) + '\t' + std::to_string(time), fields) || fields.empty()
+     || fields[0] == "none")
+        return NO_CHANGE;
+    return std::stoull(fields[0]);
+}
+
+void RemoteVar::forEachValue(uint64_t endTime, const std::function<void(uint64_t, uint64_t, const std::string&)>& fn)
+{
+    // the server sends the values a page at a time
+    std::vector<std::string> fields, lines;
+    uint64_t start = 0;
+    while (1)
+    {
+        if (!remote->request("CHANGES\t" + std::to_string(id) + '\t' + std::to_string(start) + '\t' + std::to_string(endTime),
+             fields, &lines) || fields.size() != 2)
+            return;
+        for (auto& line : lines)
+        {
+            std::vector<std::string> change;
+            boost::split(change, line, boost::is_any_of("\t"));
+            if (change.size() != 3) continue;
+            fn(std::stoull(change[0]), std::stoull(change[1]), change[2]);
+        }
+        if (fields[0] == "none") return;
+        start = std::stoull(fields[0]);
+    }
+}
+
+uint64_t RemoteArrScope::getNextChange(uint64_t time)
+{
+    std::vector<std::string> fields;
+    if (!remote->request("NEXT\t" + std::to_string(id) + '\t' + std::to_string(time), fields) || fields.empty()
+     || fields[0] == "none")
+        return NO_CHANGE;
+    return std::stoull(fields[0]);
+}
+
+RemoteWaveform::RemoteWaveform()
+    : fd(-1), topScope(nullptr), definitionsDone(false), done(false), maxTime(0), bytesRead(0), totalBytes(0),
+      parseSeconds(0)
+{}
+
+RemoteWaveform::~RemoteWaveform()
+{
+    if (fd >= 0) close(fd);
+    for (auto& node : nodes)
+    {
+        delete node;
+    }
+}
+
+bool RemoteWaveform::connect(const std::string& path, std::string& error)
+{
+    sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(address.sun_path))
+    {
+        error = "Socket path is too long: " + path;
+        return false;
+    }
+    strcpy(address.sun_path, path.c_str());
+    fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0 || ::connect(fd, (sockaddr*)&address, sizeof(address)) < 0)
+    {
+        error = "Could not connect to " + path + ": " + strerror(errno);
+        return false;
+    }
+    std::vector<std::string> fields;
+    if (!request("INFO", fields) || fields.size() < 7)
+    {
+        error = "No tabuwave server at " + path;
+        return false;
+    }
+    updateInfo();
+    return true;
+}
+
+bool RemoteWaveform::readLine(std::string& line)
+{
+    size_t end;
+    char chunk[65536];
+    while ((end = buffer.find('\n')) == std::string::npos)
+    {
+        ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+        if (n <= 0) return false;
+        buffer.append(chunk, n);
+    }
+    line = buffer.substr(0, end);
+    buffer.erase(0, end + 1);
+    return true;
+}
+
+bool RemoteWaveform::request(const std::string& request, std::vector<std::string>& fields, std::vector<std::string>* lines)
+{
+    std::lock_guard<std::mutex> lock(connectionMutex);
+    if (fd < 0) return false;
+    std::string message = request + '\n';
+    size_t sent = 0;
+    while (sent < message.size())
+    {
+        ssize_t n = send(fd, message.data() + sent, message.size() - sent, MSG_NOSIGNAL);
+        if (n <= 0) return false;
+        sent += n;
+    }
+
+    std::string line;
+    if (!readLine(line)) return false;
+    boost::split(fields, line, boost::is_any_of("\t"));
+    bool ok = (fields[0] == "OK");
+    fields.erase(fields.begin());
+    if (!ok) return false;
+    if (lines)
+    {
+        // the last field is the number of lines that follow
+        lines->clear();
+        size_t count = fields.empty() ? 0 : std::stoull(fields.back());
+        lines->reserve(count);
+        for (size_t i = 0; i < count; i++)
+        {
+            if (!readLine(line)) return false;
+            lines->push_back(line);
+        }
+    }
+    return true;
+}
+
+void RemoteWaveform::updateInfo()
+{
+    if (done) return;
+    auto now = std::chrono::steady_clock::now();
+    if (now - lastInfo < std::chrono::milliseconds(INFO_INTERVAL_MS)) return;
+    lastInfo = now;
+    std::vector<std::string> fields;
+    if (!request("INFO", fields) || fields.size() < 7) return;
+    bool serverDefinitionsDone = (fields[0] == "1");
+    maxTime = std::stoull(fields[2]);
+    bytesRead = std::stoull(fields[3]);
+    totalBytes = std::stoull(fields[4]);
+    parseSeconds = std::stod(fields[5]);
+    timescale = fields[6];
+    if (serverDefinitionsDone && !definitionsDone) definitionsDone = buildTree();
+    // done only once the tree is copied, so nothing is requested after
+    done = definitionsDone && (fields[1] == "1");
+}
+
+bool RemoteWaveform::buildTree()
+{
+    std::vector<std::string> fields, lines;
+    if (!request("TREE", fields, &lines) || lines.empty()) return false;
+    for (size_t id = 0; id < lines.size(); id++)
+    {
+        std::vector<std::string> entry;
+        boost::split(entry, lines[id], boost::is_any_of("\t"));
+        if (entry.size() != 5) return false;
+        long parentId = std::stol(entry[0]);
+        long element = std::stol(entry[3]);
+
+        VcdNode* node;
+        if (entry[1] == "S")
+        {
+            node = new VcdScope();
+        }
+        else if (entry[1] == "A")
+        {
+            node = new RemoteArrScope(this, id);
+        }
+        else
+        {
+            RemoteVar* var = new RemoteVar(this, id);
+            var->size = std::stoull(entry[2]);
+            if (entry[1] == "R")
+                var->valueKind = VcdVar::REAL;
+            else if (entry[1] == "T")
+                var->valueKind = VcdVar::STRING;
+            node = var;
+        }
+        node->name = entry[4];
+        node->parent = nullptr;
+        nodes.push_back(node);
+
+        if (parentId < 0 || (size_t)parentId >= id) continue;
+        VcdScope* parent = dynamic_cast<VcdScope*>(nodes[parentId]);
+        if (!parent) continue;
+        node->parent = parent;
+        parent->children[node->name] = node;
+        if (element >= 0 && parent->getType() == VcdNode::ARR_SCOPE)
+        {
+            // keep elements ordered by index for windowed access
+            std::vector<VcdVar*>& elements = dynamic_cast<VcdArrScope*>(parent)->elements;
+            if (elements.size() <= (size_t)element) elements.resize(element + 1, nullptr);
+            elements[element] = dynamic_cast<VcdVar*>(node);
+        }
+    }
+    topScope = dynamic_cast<VcdScope*>(nodes[0]);
+    if (!topScope) return false;
+    index.build(topScope);
+    index.buildTrigrams();
+    return true;
+}
+
+bool RemoteWaveform::isDefinitionsDone()
+{
+    updateInfo();
+    return definitionsDone;
+}
+
+bool RemoteWaveform::isDone()
+{
+    updateInfo();
+    return done;
+}
+
+uint64_t RemoteWaveform::getBytesRead()
+{
+    updateInfo();
+    return bytesRead;
+}
+
+uint64_t RemoteWaveform::getTotalBytes()
+{
+    updateInfo();
+    return totalBytes;
+}
+
+double RemoteWaveform::getParseSeconds()
+{
+    updateInfo();
+    return parseSeconds;
+}
+
+std::vector<std::string> RemoteWaveform::getReport()
+{
+    std::vector<std::string> fields, lines;
+    request("REPORT", fields, &lines);
+    return lines;
+}
+
+std::shared_mutex& RemoteWaveform::getValuesMutex()
+{
+    return valuesMutex;
+}
+
+VcdScope* RemoteWaveform::getTop()
+{
+    return topScope;
+}
+
+SignalIndex& RemoteWaveform::getIndex()
+{
+    return index;
+}
+
+size_t RemoteWaveform::getMaxTime()
+{
+    updateInfo();
+    return maxTime;
+}
+
+std::string RemoteWaveform::getTimescale()
+{
+    updateInfo();
+    return timescale;
+}
+
+std::vector<DeltaEvent> RemoteWaveform::getDeltaEvents(uint64_t time)
+{
+    std::vector<std::string> fields, lines;
+    std::vector<DeltaEvent> events;
+    if (!request("DELTAS\t" + std::to_string(time), fields, &lines)) return events;
+    for (auto& line : lines)
+    {
+        std::vector<std::string> event;
+        boost::split(event, line, boost::is_any_of("\t"));
+        if (event.size() != 3) continue;
+        size_t id = std::stoull(event[0]);
+        VcdVar* var = (id < nodes.size()) ? dynamic_cast<VcdVar*>(nodes[id]) : nullptr;
+        if (var) events.push_back(DeltaEvent{var, event[1], event[2]});
+    }
+    return events;
+}
+
+uint64_t RemoteWaveform::getNextDeltaTime(uint64_t time)
+{
+    std::vector<std::string> fields;
+    if (!request("NEXTDELTA\t" + std::to_string(time), fields) || fields.empty() || fields[0] == "none")
+        return NO_CHANGE;
+    return std::stoull(fields[0]);
+}
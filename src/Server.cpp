@@ -0,0 +1,396 @@
+/**
+ * Author:          Cynthia Wang
+ * Date created:    10/19/2026
+ * Organization:    ECE 4122
+ *
+ * Description:
+ * Source file for Server class and functions. See Server.hpp for function descriptions.
+*/
+
+#include "Server.hpp"
+
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <shared_mutex>
+#include <sstream>
+#include <thread>
+
+#include <boost/algorithm/string.hpp>
+
+#include "Batch.hpp"
+
+/**
+ * @brief Parses a whole field as an unsigned number.
+ */
+static bool parseField(const std::string& field, uint64_t& number)
+{
+    if (field.empty() || field.find_first_not_of("0123456789") != std::string::npos) return false;
+    try
+    {
+        number = std::stoull(field);
+    }
+    catch (const std::out_of_range&)
+    {
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Writes all of a buffer to a socket.
+ *
+ * @return false if the connection is closed
+ */
+static bool sendAll(int fd, const std::string& buffer)
+{
+    size_t sent = 0;
+    while (sent < buffer.size())
+    {
+        ssize_t n = send(fd, buffer.data() + sent, buffer.size() - sent, MSG_NOSIGNAL);
+        if (n <= 0) return false;
+        sent += n;
+    }
+    return true;
+}
+
+const std::string& Server::getTree()
+{
+    std::lock_guard<std::mutex> lock(treeMutex);
+    if (!tree.empty()) return tree;
+
+    // array index of each element, which is not part of the index
+    SignalIndex& index = parser->getIndex();
+    std::map<VcdNode*, size_t> elements;
+    for (SignalIndex::Id id = 0; id < index.size(); id++)
+    {
+        VcdNode* node = index.getNode(id);
+        if (node->getType() != VcdNode::ARR_SCOPE) continue;
+        VcdArrScope* array = dynamic_cast<VcdArrScope*>(node);
+        for (size_t i = 0; i < array->getSize(); i++)
+        {
+            if (array->getElement(i)) elements[array->getElement(i)] = i;
+        }
+    }
+
+    std::string lines;
+    for (SignalIndex::Id id = 0; id < index.size(); id++)
+    {
+        VcdNode* node = index.getNode(id);
+        SignalIndex::Id parent = index.getParent(id);
+        char kind = (node->getType() == VcdNode::SCOPE) ? 'S' : (node->getType() == VcdNode::ARR_SCOPE) ? 'A' : 'V';
+        if (kind == 'V' && dynamic_cast<VcdVar*>(node)->getValueKind() != VcdVar::VECTOR) 
+            kind = (dynamic_cast<VcdVar*>(node)->getValueKind() == VcdVar::REAL) ? 'R' : 'T';
+        size_t size = (kind == 'S') ? 0 : dynamic_cast<VcdPrimitive*>(node)->getSize();
+        auto element = elements.find(node);
+        lines += ((parent == SignalIndex::NONE) ? std::string("-1") : std::to_string(parent)) + '\t' + kind + '\t'
+            + std::to_string(size) + '\t'
+            + ((element == elements.end()) ? std::string("-1") : std::to_string(element->second)) + '\t'
+            + node->getName() + '\n';
+    }
+    tree = "OK\t" + std::to_string(index.size()) + '\n' + lines;
+    return tree;
+}
+
+std::string Server::handle(const std::string& request)
+{
+    std::vector<std::string> fields;
+    boost::split(fields, request, boost::is_any_of("\t"));
+    const std::string& command = fields[0];
+
+    if (command == "INFO")
+    {
+        std::ostringstream ss;
+        ss << "OK\t" << parser->isDefinitionsDone() << '\t' << parser->isDone() << '\t' << parser->getMaxTime() << '\t'
+            << parser->getBytesRead() << '\t' << parser->getTotalBytes() << '\t' << parser->getParseSeconds() << '\t'
+            << parser->getTimescale() << '\n';
+        return ss.str();
+    }
+    if (command == "REPORT")
+    {
+        std::vector<std::string> report = parser->getReport();
+        std::string response = "OK\t" + std::to_string(report.size()) + '\n';
+        for (auto& line : report)
+        {
+            response += line + '\n';
+        }
+        return response;
+    }
+    if (!parser->isDefinitionsDone()) return "ERR\tDefinitions are still being parsed.\n";
+    if (command == "TREE") return getTree();
+
+    SignalIndex& index = parser->getIndex();
+    if (command == "SEARCH")
+    {
+        uint64_t limit;
+        if (fields.size() != 3 || !parseField(fields[1], limit)) return "ERR\tUsage: SEARCH limit query\n";
+        std::vector<SignalIndex::Id> ids;
+        {
+            std::lock_guard<std::mutex> lock(searchMutex);
+            ids = index.search(fields[2], limit);
+        }
+        std::string response = "OK\t" + std::to_string(ids.size()) + '\n';
+        for (auto id : ids)
+        {
+            response += std::to_string(id) + '\t' + index.getPath(id) + '\n';
+        }
+        return response;
+    }
+    if (command == "QUERY")
+    {
+        if (!parser->isDone()) return "ERR\tValues are still being parsed.\n";
+        std::istringstream in(request.substr(command.size() + 1 < request.size() ? command.size() + 1 : request.size()));
+        std::ostringstream out;
+        Batch batch(parser);
+        batch.run(in, out);
+        std::vector<std::string> lines;
+        std::string result = out.str();
+        boost::trim_right(result);
+        boost::split(lines, result, boost::is_any_of("\n"));
+        std::string response = "OK\t" + std::to_string(lines.size()) + '\n';
+        for (auto& line : lines)
+        {
+            response += line + '\n';
+        }
+        return response;
+    }
+
+    if (command == "DELTAS" || command == "NEXTDELTA")
+    {
+        uint64_t time;
+        if (fields.size() != 2 || !parseField(fields[1], time)) return "ERR\tUsage: " + command + " time\n";
+        if (command == "NEXTDELTA")
+        {
+            uint64_t next = parser->getNextDeltaTime(time);
+            return "OK\t" + ((next == UINT64_MAX) ? std::string("none") : std::to_string(next)) + '\n';
+        }
+        std::vector<DeltaEvent> events = parser->getDeltaEvents(time);
+        std::string response = "OK\t" + std::to_string(events.size()) + '\n';
+        for (auto& event : events)
+        {
+            response += std::to_string(index.getId(event.var)) + '\t' + event.value + '\t' + event.previous + '\n';
+        }
+        return response;
+    }
+
+    // requests about one node
+    uint64_t id, time, end = 0;
+    bool changes = (command == "CHANGES");
+    if (fields.size() != (changes ? 4u : 3u) || !parseField(fields[1], id) || !parseField(fields[2], time)
+     || (changes && !parseField(fields[3], end)) || id >= index.size())
+    {
+        return "ERR\tUnknown request or invalid id or time.\n";
+    }
+    VcdNode* node = index.getNode(id);
+    std::shared_lock<std::shared_mutex> lock(parser->getValuesMutex());
+    if (command == "NEXT" && node->getType() != VcdNode::SCOPE)
+    {
+        uint64_t next = dynamic_cast<VcdPrimitive*>(node)->getNextChange(time);
+        return "OK\t" + ((next == (uint64_t)-1) ? std::string("none") : std::to_string(next)) + '\n';
+    }
+    if (node->getType() != VcdNode::VAR) return "ERR\tNot a var.\n";
+    VcdVar* var = dynamic_cast<VcdVar*>(node);
+    if (command == "VALUE")
+    {
+        return "OK\t" + var->valueAt(time) + '\n';
+    }
+    if (changes)
+    {
+        // a page of values, so a clock cannot make a response of gigabytes
+        std::string lines, next = "none";
+        size_t count = 0;
+        var->forEachValueFrom(time, std::min(end, (uint64_t)parser->getMaxTime()),
+            [&](uint64_t start, uint64_t end, const std::string& value)
+            {
+                if (count == MAX_CHANGES)
+                {
+                    next = std::to_string(start);
+                    return false;
+                }
+                lines += std::to_string(start) + '\t' + std::to_string(end) + '\t' + value + '\n';
+                count++;
+                return true;
+            }
+        );
+        return "OK\t" + next + '\t' + std::to_string(count) + '\n' + lines;
+    }
+    return "ERR\tUnknown request or invalid id or time.\n";
+}
+
+void Server::work()
+{
+    while (1)
+    {
+        std::pair<int, std::string> request;
+        {
+            std::unique_lock<std::mutex> lock(queueMutex);
+            queueCondition.wait(lock, [this]() { return !requests.empty(); });
+            request = std::move(requests.front());
+            requests.pop_front();
+        }
+        bool sent = sendAll(request.first, handle(request.second));
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            answered.emplace_back(request.first, sent);
+        }
+        // the pipe is already readable if it is full
+        char byte = 0;
+        ssize_t written = write(wake[1], &byte, 1);
+        (void)written;
+    }
+}
+
+bool Server::dispatch(int fd, Connection& connection)
+{
+    while (!connection.busy)
+    {
+        size_t end = connection.buffer.find('\n');
+        if ((end == std::string::npos) ? connection.buffer.size() > MAX_REQUEST_BYTES : end > MAX_REQUEST_BYTES)
+        {
+            sendAll(fd, "ERR\tRequest too long.\n");
+            disconnect(fd);
+            return false;
+        }
+        if (end == std::string::npos) return true;
+        std::string request = connection.buffer.substr(0, end);
+        connection.buffer.erase(0, end + 1);
+        if (!request.empty() && request.back() == '\r') request.pop_back();
+        if (request.empty()) continue;
+
+        connection.busy = true;
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            requests.emplace_back(fd, std::move(request));
+        }
+        queueCondition.notify_one();
+    }
+    return true;
+}
+
+void Server::disconnect(int fd)
+{
+    close(fd);
+    connections.erase(fd);
+}
+
+Server::~Server()
+{
+    if (listener >= 0) close(listener);
+    if (wake[0] >= 0) close(wake[0]);
+    if (wake[1] >= 0) close(wake[1]);
+}
+
+bool Server::listen(const std::string& path, std::string& error)
+{
+    listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (listener < 0 || path.size() >= sizeof(address.sun_path) || pipe(wake) < 0
+     || fcntl(wake[1], F_SETFL, O_NONBLOCK) < 0)
+    {
+        error = "Could not create socket " + path;
+        return false;
+    }
+    strcpy(address.sun_path, path.c_str());
+    struct stat st;
+    if (lstat(path.c_str(), &st) == 0)
+    {
+        if (!S_ISSOCK(st.st_mode))
+        {
+            error = "Could not listen on " + path + ": not a socket";
+            return false;
+        }
+        unlink(path.c_str());
+    }
+    if (bind(listener, (sockaddr*)&address, sizeof(address)) < 0 || ::listen(listener, 64) < 0)
+    {
+        error = "Could not listen on " + path + ": " + strerror(errno);
+        return false;
+    }
+    return true;
+}
+
+void Server::run()
+{
+    // while no more files can be opened, wait this long to accept again
+    const auto acceptRetry = std::chrono::milliseconds(100);
+
+    signal(SIGPIPE, SIG_IGN);
+    for (size_t i = 0; i < numThreads; i++)
+    {
+        std::thread([this]() { work(); }).detach();
+    }
+
+    auto acceptAfter = std::chrono::steady_clock::now();
+    std::vector<pollfd> fds;
+    while (1)
+    {
+        // connections whose request was answered take their next one
+        std::vector<std::pair<int, bool>> done;
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            done.swap(answered);
+        }
+        for (auto& [fd, sent] : done)
+        {
+            if (!sent)
+            {
+                disconnect(fd);
+                continue;
+            }
+            connections[fd].busy = false;
+            dispatch(fd, connections[fd]);
+        }
+
+        // connections waiting for a response are not read until it is sent
+        bool full = connections.size() >= MAX_CONNECTIONS;
+        bool accepting = !full && std::chrono::steady_clock::now() >= acceptAfter;
+        fds.clear();
+        fds.push_back(pollfd{wake[0], POLLIN, 0});
+        if (accepting) fds.push_back(pollfd{listener, POLLIN, 0});
+        for (auto& [fd, connection] : connections)
+        {
+            if (!connection.busy) fds.push_back(pollfd{fd, POLLIN, 0});
+        }
+        int timeoutMs = (full || accepting) ? -1 : (int)acceptRetry.count();
+        if (poll(fds.data(), fds.size(), timeoutMs) <= 0) continue;
+
+        if (fds[0].revents)
+        {
+            char bytes[64];
+            ssize_t drained = read(wake[0], bytes, sizeof(bytes));
+            (void)drained;
+        }
+        for (size_t i = 1; i < fds.size(); i++)
+        {
+            if (!fds[i].revents) continue;
+            int fd = fds[i].fd;
+            if (fd == listener)
+            {
+                int client = accept(listener, nullptr, nullptr);
+                if (client >= 0)
+                    connections[client] = Connection{"", false};
+                else if (errno == EMFILE || errno == ENFILE || errno == ENOBUFS || errno == ENOMEM)
+                    acceptAfter = std::chrono::steady_clock::now() + acceptRetry;
+                continue;
+            }
+            char chunk[4096];
+            ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+            if (n <= 0)
+            {
+                disconnect(fd);
+                continue;
+            }
+            connections[fd].buffer.append(chunk, n);
+            dispatch(fd, connections[fd]);
+        }
+    }
+}
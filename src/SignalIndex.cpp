@@ -0,0 +1,294 @@
+/**
+ * Author:          Cynthia Wang
+ * Date created:    10/19/2026
+ * Organization:    ECE 4122
+ *
+ * Description:
+ * Source file for SignalIndex class and functions. See SignalIndex.hpp for function descriptions.
+*/
+
+#include "SignalIndex.hpp"
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+#include <cctype>
+
+// candidates scored by each task of a search, so short lists of candidates
+// are scored on the calling thread alone
+#define MIN_CANDIDATES_PER_TASK 4096
+
+/**
+ * @brief Case-insensitive search for `term` in `str` between `from` and `to`.
+ *
+ * @return size_t position of the first occurrence, or std::string::npos
+ */
+static size_t findNoCase(const std::string& str, size_t from, size_t to, const std::string& term)
+{
+    auto it = std::search(
+        str.begin() + from, str.begin() + to, term.begin(), term.end(),
+        [](char a, char b)
+        {
+            return std::tolower((unsigned char)a) == b;
+        }
+    );
+    return (it == str.begin() + to) ? std::string::npos : it - str.begin();
+}
+
+/**
+ * @brief Splits a query into lowercase terms separated by spaces or dots.
+ */
+static std::vector<std::string> splitTerms(const std::string& query)
+{
+    std::vector<std::string> terms(1);
+    for (char c : query)
+    {
+        if (c == ' ' || c == '.')
+        {
+            if (!terms.back().empty()) terms.emplace_back();
+        }
+        else
+        {
+            terms.back() += std::tolower((unsigned char)c);
+        }
+    }
+    if (terms.back().empty()) terms.pop_back();
+    return terms;
+}
+
+/**
+ * @brief Packs three lowercase characters into a trigram key.
+ */
+static inline uint32_t trigramKey(const char* c)
+{
+    return ((uint32_t)(unsigned char)std::tolower((unsigned char)c[0]) << 16)
+         | ((uint32_t)(unsigned char)std::tolower((unsigned char)c[1]) << 8)
+         | (uint32_t)(unsigned char)std::tolower((unsigned char)c[2]);
+}
+
+void SignalIndex::build(VcdScope* top)
+{
+    entries.clear();
+    pathMap.clear();
+    nodeMap.clear();
+    if (top) addEntries(top, NONE, "");
+}
+
+void SignalIndex::addEntries(VcdNode* node, Id parent, const std::string& prefix)
+{
+    Id id = entries.size();
+    std::string path = prefix.empty() ? node->getName() : prefix + '.' + node->getName();
+    entries.push_back(Entry{node, parent, (uint32_t)(path.size() - node->getName().size()), path});
+    pathMap.emplace(path, id);
+    nodeMap.emplace(node, id);
+
+    if (node->getType() == VcdNode::SCOPE || node->getType() == VcdNode::ARR_SCOPE)
+    {
+        // elements of an unpacked array are named like `arr[0]` after the
+        // scope containing the array rather than after the array itself
+        const std::string& childPrefix = (node->getType() == VcdNode::ARR_SCOPE) ? prefix : path;
+        for (auto& child : dynamic_cast<VcdScope*>(node)->getChildren())
+        {
+            addEntries(child.second, id, childPrefix);
+        }
+    }
+}
+
+void SignalIndex::buildTrigrams()
+{
+    for (Id id = 0; id < entries.size(); id++)
+    {
+        const std::string& path = entries[id].path;
+        for (size_t i = entries[id].nameStart; i + 3 <= path.size(); i++)
+        {
+            std::vector<Id>& ids = trigrams[trigramKey(&path[i])];
+            if (ids.empty() || ids.back() != id) ids.push_back(id);
+        }
+    }
+    trigramsReady.store(true, std::memory_order_release);
+}
+
+VcdNode* SignalIndex::find(const std::string& path)
+{
+    auto it = pathMap.find(path);
+    return (it == pathMap.end()) ? nullptr : entries[it->second].node;
+}
+
+SignalIndex::Id SignalIndex::getId(VcdNode* node)
+{
+    auto it = nodeMap.find(node);
+    return (it == nodeMap.end()) ? NONE : it->second;
+}
+
+int SignalIndex::score(const Entry& entry, const std::vector<std::string>& terms)
+{
+    const std::string& path = entry.path;
+    size_t nameStart = entry.nameStart;
+    const std::string& last = terms.back();
+
+    // the last term must be part of the name
+    size_t pos = findNoCase(path, nameStart, path.size(), last);
+    if (pos == std::string::npos) return -1;
+    int s = 1000;
+    if (pos == nameStart)
+    {
+        s += 300;
+        if (last.size() == path.size() - nameStart) s += 500; // exact name
+    }
+    else if (path[pos - 1] == '_' || path[pos - 1] == '[')
+    {
+        s += 100;
+    }
+
+    // the other terms must appear in order in the path of the scope,
+    // preferably as substrings, otherwise as subsequences
+    size_t at = 0;
+    for (size_t t = 0; t + 1 < terms.size(); t++)
+    {
+        size_t found = findNoCase(path, at, nameStart, terms[t]);
+        if (found != std::string::npos)
+        {
+            s += 50;
+            at = found + terms[t].size();
+            continue;
+        }
+        for (char c : terms[t])
+        {
+            while (at < nameStart && std::tolower((unsigned char)path[at]) != c) at++;
+            if (at == nameStart) return -1;
+            at++;
+        }
+    }
+
+    // prefer shorter names
+    return s - (int)std::min(path.size(), (size_t)500);
+}
+
+std::vector<SignalIndex::Id> SignalIndex::search(const std::string& query, size_t limit, size_t* total)
+{
+    std::vector<std::string> terms = splitTerms(query);
+    if (terms.empty())
+    {
+        lastQuery.clear();
+        lastMatches.clear();
+        if (total) *total = 0;
+        return {};
+    }
+    const std::string& last = terms.back();
+
+    // determine candidates, from the fewest possible
+    std::vector<Id> candidates;
+    bool extendsLast = !lastQuery.empty()
+        && lastQuery.back() != ' ' && lastQuery.back() != '.'
+        && query.compare(0, lastQuery.size(), lastQuery) == 0
+        && query.find_first_of(" .", lastQuery.size()) == std::string::npos;
+    if (extendsLast)
+    {
+        // matches of a longer last term are a subset of the previous matches
+        candidates.swap(lastMatches);
+    }
+    else if (last.size() >= 3 && trigramsReady.load(std::memory_order_acquire))
+    {
+        // names containing the last term contain all of its trigrams
+        std::vector<const std::vector<Id>*> lists;
+        for (size_t i = 0; i + 3 <= last.size(); i++)
+        {
+            auto it = trigrams.find(trigramKey(&last[i]));
+            if (it == trigrams.end())
+            {
+                lists.clear();
+                break;
+            }
+            lists.push_back(&it->second);
+        }
+        std::sort(lists.begin(), lists.end(),
+            [](const std::vector<Id>* a, const std::vector<Id>* b)
+            {
+                return a->size() < b->size();
+            }
+        );
+        if (!lists.empty()) candidates = *lists[0];
+        for (size_t i = 1; i < lists.size() && !candidates.empty(); i++)
+        {
+            std::vector<Id> intersection;
+            std::set_intersection(candidates.begin(), candidates.end(),
+                lists[i]->begin(), lists[i]->end(), std::back_inserter(intersection));
+            candidates.swap(intersection);
+        }
+    }
+    else
+    {
+        candidates.resize(entries.size());
+        for (Id id = 0; id < entries.size(); id++) candidates[id] = id;
+    }
+
+    // score the candidates in chunks on the pool, keeping the matches in
+    // order of id, then rank them
+    ThreadPool& pool = ThreadPool::get();
+    size_t numTasks = std::min(pool.getThreads() * 4,
+        (candidates.size() + MIN_CANDIDATES_PER_TASK - 1) / MIN_CANDIDATES_PER_TASK);
+    std::vector<std::vector<std::pair<int, Id>>> taskScored(numTasks);
+    pool.parallelFor(numTasks,
+        [&](size_t task, size_t)
+        {
+            size_t first = candidates.size() * task / numTasks;
+            size_t last = candidates.size() * (task + 1) / numTasks;
+            for (size_t i = first; i < last; i++)
+            {
+                int s = score(entries[candidates[i]], terms);
+                if (s >= 0) taskScored[task].emplace_back(-s, candidates[i]);
+            }
+        }
+    );
+    std::vector<std::pair<int, Id>> scored;
+    lastMatches.clear();
+    for (auto& matches : taskScored)
+    {
+        for (auto& match : matches)
+        {
+            scored.push_back(match);
+            lastMatches.push_back(match.second);
+        }
+    }
+    lastQuery = query;
+    if (total) *total = scored.size();
+
+    size_t n = std::min(limit, scored.size());
+    std::partial_sort(scored.begin(), scored.begin() + n, scored.end());
+    std::vector<Id> results;
+    results.reserve(n);
+    for (size_t i = 0; i < n; i++) results.push_back(scored[i].second);
+    return results;
+}
+
+VcdNode* SignalIndex::getNode(Id id)
+{
+    return entries[id].node;
+}
+
+SignalIndex::Id SignalIndex::getParent(Id id)
+{
+    return entries[id].parent;
+}
+
+const std::string& SignalIndex::getPath(Id id)
+{
+    return entries[id].path;
+}
+
+size_t SignalIndex::size()
+{
+    return entries.size();
+}
+
+size_t SignalIndex::getEntryBytes(Id id)
+{
+    const Entry& entry = entries[id];
+    size_t pathBytes = (entry.path.capacity() > std::string().capacity()) ? entry.path.capacity() + 1 : 0;
+    // a hash table node holds the next pointer and the cached hash with the pair
+    size_t bytes = sizeof(Entry) + pathBytes
+        + 2 * sizeof(void*) + sizeof(std::pair<const std::string, Id>) + pathBytes
+        + 2 * sizeof(void*) + sizeof(std::pair<VcdNode* const, Id>);
+    if (trigramsReady.load(std::memory_order_acquire) && entry.path.size() >= entry.nameStart + 3)
+        bytes += (entry.path.size() - entry.nameStart - 2) * sizeof(Id);
+    return bytes;
+}
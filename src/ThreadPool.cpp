@@ -0,0 +1,222 @@
+/**
+ * Author:          Cynthia Wang
+ * Date created:    10/19/2026
+ * Organization:    ECE 4122
+ *
+ * Description:
+ * Source file for ThreadPool class and functions. See ThreadPool.hpp for function descriptions.
+*/
+
+#include "ThreadPool.hpp"
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+size_t ThreadPool::configuredThreads = 0;
+
+/**
+ * @brief Get the CPU quota set in one cgroup directory, rounded up to whole
+ * cores.
+ *
+ * @param dir (const std::string&) directory of the cgroup
+ * @param v2 (bool) whether it is in a cgroup v2 hierarchy
+ * @return size_t number of cores, or 0 if there is no quota
+ */
+static size_t quotaIn(const std::string& dir, bool v2)
+{
+    uint64_t period = 0;
+    if (v2)
+    {
+        std::ifstream max(dir + "/cpu.max");
+        std::string quota;
+        if (!(max >> quota >> period) || quota == "max" || !period) return 0;
+        return (std::stoull(quota) + period - 1) / period;
+    }
+    std::ifstream v1Quota(dir + "/cpu.cfs_quota_us");
+    std::ifstream v1Period(dir + "/cpu.cfs_period_us");
+    int64_t v1QuotaUs = -1;
+    if (v1Quota >> v1QuotaUs && v1Period >> period && v1QuotaUs > 0 && period)
+        return (v1QuotaUs + period - 1) / period;
+    return 0;
+}
+
+/**
+ * @brief Get the CPU quota of the cgroup of the process, from cgroup v2 or
+ * v1, as the smallest quota of its cgroup and the cgroups above it, since a
+ * job scheduler or systemd slice sets it on the cgroup of the job rather
+ * than on the root of the hierarchy.
+ *
+ * @return size_t number of cores, or 0 if there is no quota
+ */
+static size_t cgroupQuota()
+{
+    size_t cores = 0;
+    // lines are <id>:<controllers>:<path>, with no controllers for cgroup v2
+    std::ifstream file("/proc/self/cgroup");
+    std::string line;
+    while (std::getline(file, line))
+    {
+        size_t first = line.find(':');
+        size_t second = (first == std::string::npos) ? first : line.find(':', first + 1);
+        if (second == std::string::npos) continue;
+        std::string controllers = line.substr(first + 1, second - first - 1);
+        std::string path = line.substr(second + 1);
+        bool v2 = controllers.empty();
+        std::vector<std::string> mounts;
+        if (v2)
+            mounts = {"/sys/fs/cgroup", "/sys/fs/cgroup/unified"};
+        else if (("," + controllers + ",").find(",cpu,") != std::string::npos)
+            mounts = {"/sys/fs/cgroup/" + controllers, "/sys/fs/cgroup/cpu"};
+        else
+            continue;
+        // a path outside a container's cgroup namespace is missing from its
+        // mount, whose root is then the cgroup of the container
+        for (auto& mount : mounts)
+        {
+            for (std::string dir = path; ; dir.erase(dir.rfind('/')))
+            {
+                size_t quota = quotaIn(mount + dir, v2);
+                if (quota && (!cores || quota < cores)) cores = quota;
+                if (dir.rfind('/') == std::string::npos) break;
+            }
+        }
+    }
+    return cores;
+}
+
+ThreadPool::ThreadPool(size_t numThreads)
+{
+    for (size_t i = 1; i < numThreads; i++)
+    {
+        workers.emplace_back(
+            std::thread(
+                [this]()
+                {
+                    this->workerLoop();
+                }
+            )
+        );
+    }
+}
+
+size_t ThreadPool::defaultThreads()
+{
+    size_t numThreads = std::max(std::thread::hardware_concurrency(), 1u);
+#ifdef __linux__
+    cpu_set_t set;
+    if (sched_getaffinity(0, sizeof(set), &set) == 0)
+        numThreads = std::min(numThreads, (size_t)CPU_COUNT(&set));
+    size_t quota = cgroupQuota();
+    if (quota) numThreads = std::min(numThreads, quota);
+#endif
+    return std::max(numThreads, (size_t)1);
+}
+
+void ThreadPool::setThreads(size_t numThreads)
+{
+    configuredThreads = numThreads;
+}
+
+ThreadPool& ThreadPool::get()
+{
+    // never destroyed, so exiting does not join workers still busy with a
+    // parse in the background
+    static ThreadPool* pool = new ThreadPool(configuredThreads ? configuredThreads : defaultThreads());
+    return *pool;
+}
+
+size_t ThreadPool::getThreads()
+{
+    return workers.size() + 1;
+}
+
+size_t ThreadPool::getWorkers()
+{
+    return workers.size();
+}
+
+void ThreadPool::workerLoop()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    while (1)
+    {
+        taskAvailable.wait(lock, [this]() { return !tasks.empty(); });
+        std::function<void()> task = std::move(tasks.front());
+        tasks.pop_front();
+        lock.unlock();
+        task();
+        lock.lock();
+    }
+}
+
+void ThreadPool::submit(std::function<void()> task)
+{
+    if (workers.empty())
+    {
+        task();
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        tasks.push_back(std::move(task));
+    }
+    taskAvailable.notify_one();
+}
+
+void ThreadPool::parallelFor(size_t count, const std::function<void(size_t, size_t)>& fn)
+{
+    if (count == 0) return;
+
+    /**
+     * @brief Data structure for the progress of a loop, shared with the
+     * helper tasks since they may start after the loop is done.
+     */
+    struct Loop
+    {
+        std::atomic<size_t> next;
+        std::atomic<size_t> finished;
+        std::atomic<size_t> slots;
+        std::mutex mutex;
+        std::condition_variable done;
+    };
+    auto loop = std::make_shared<Loop>();
+    loop->next = 0;
+    loop->finished = 0;
+    loop->slots = 0;
+
+    // helpers that start after every index is handed out return without
+    // touching fn, which only lives until the loop is done
+    auto work = [loop, count, &fn]()
+    {
+        size_t slot = loop->slots.fetch_add(1);
+        size_t i;
+        size_t ran = 0;
+        while ((i = loop->next.fetch_add(1)) < count)
+        {
+            fn(i, slot);
+            ran++;
+        }
+        if (ran && loop->finished.fetch_add(ran) + ran == count)
+        {
+            std::lock_guard<std::mutex> lock(loop->mutex);
+            loop->done.notify_all();
+        }
+    };
+    size_t numHelpers = std::min(workers.size(), count - 1);
+    for (size_t i = 0; i < numHelpers; i++)
+    {
+        submit(work);
+    }
+    work();
+
+    std::unique_lock<std::mutex> lock(loop->mutex);
+    loop->done.wait(lock, [&]() { return loop->finished == count; });
+}
@@ -0,0 +1,123 @@
+/**
+ * Author:          Cynthia Wang
+ * Date created:    10/19/2026
+ * Organization:    ECE 4122
+ *
+ * Description:
+ * Source file for TimeColumn class and functions. See TimeColumn.hpp for function descriptions.
+*/
+
+#include "TimeColumn.hpp"
+
+#include <algorithm>
+
+void TimeColumn::push_back(uint64_t time)
+{
+    if (count % BLOCK_SIZE == 0)
+    {
+        // the first time of a block is kept in the skip index only
+        blocks.push_back(Block{time, deltas.size()});
+    }
+    else
+    {
+        uint64_t delta = time - lastTime;
+        while (delta >= 0x80)
+        {
+            deltas.push_back((uint8_t)(delta | 0x80));
+            delta >>= 7;
+        }
+        deltas.push_back((uint8_t)delta);
+    }
+    lastTime = time;
+    count++;
+}
+
+size_t TimeColumn::size()
+{
+    return count;
+}
+
+bool TimeColumn::empty()
+{
+    return count == 0;
+}
+
+uint64_t TimeColumn::back()
+{
+    return lastTime;
+}
+
+bool TimeColumn::decodeBlock(size_t block, const std::function<bool(size_t, uint64_t)>& fn)
+{
+    size_t pos = block * BLOCK_SIZE;
+    size_t end = std::min(pos + BLOCK_SIZE, count);
+    uint64_t time = blocks[block].firstTime;
+    const uint8_t* delta = deltas.data() + blocks[block].offset;
+    if (!fn(pos, time)) return false;
+    for (pos++; pos < end; pos++)
+    {
+        uint64_t value = 0;
+        for (unsigned shift = 0;; shift += 7)
+        {
+            uint8_t byte = *delta++;
+            value |= (uint64_t)(byte & 0x7f) << shift;
+            if (!(byte & 0x80)) break;
+        }
+        time += value;
+        if (!fn(pos, time)) return false;
+    }
+    return true;
+}
+
+uint64_t TimeColumn::at(size_t pos)
+{
+    uint64_t result = 0;
+    decodeBlock(pos / BLOCK_SIZE,
+        [&](size_t i, uint64_t time)
+        {
+            result = time;
+            return i < pos;
+        }
+    );
+    return result;
+}
+
+size_t TimeColumn::upperBound(uint64_t time)
+{
+    // last block starting at or before time
+    auto it = std::upper_bound(blocks.begin(), blocks.end(), time,
+        [](uint64_t t, const Block& block)
+        {
+            return t < block.firstTime;
+        }
+    );
+    if (it == blocks.begin()) return 0;
+    size_t result = std::min((size_t)(it - blocks.begin()) * BLOCK_SIZE, count);
+    decodeBlock(it - blocks.begin() - 1,
+        [&](size_t i, uint64_t t)
+        {
+            if (t <= time) return true;
+            result = i;
+            return false;
+        }
+    );
+    return result;
+}
+
+void TimeColumn::forEach(const std::function<bool(size_t, uint64_t)>& fn, size_t from)
+{
+    // times before `from` in its block are decoded but not passed on
+    auto skip = [&](size_t pos, uint64_t time)
+    {
+        return pos < from || fn(pos, time);
+    };
+    for (size_t block = from / BLOCK_SIZE; block < blocks.size(); block++)
+    {
+        if (!decodeBlock(block, skip)) return;
+    }
+}
+
+size_t TimeColumn::getMemoryBytes()
+{
+    return blocks.capacity() * sizeof(Block) + deltas.capacity();
+}
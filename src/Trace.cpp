@@ -0,0 +1,114 @@
+/**
+ * Author:          Cynthia Wang
+ * Date created:    10/19/2026
+ * Organization:    ECE 4122
+ *
+ * Description:
+ * Source file for Trace class and functions. See Trace.hpp for function descriptions.
+*/
+
+#include "Trace.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <vector>
+
+/**
+ * @brief Data structure for a recorded span.
+ */
+struct TraceEvent
+{
+    std::string name;
+    const char* category;
+    double startUs;
+    double durationUs;
+    uint32_t thread;
+};
+
+static std::atomic<bool> traceEnabled(false);
+static std::chrono::steady_clock::time_point traceEpoch;
+static std::string tracePath;
+static std::mutex traceMutex;
+static std::vector<TraceEvent> traceEvents;
+static std::atomic<uint32_t> traceThreads(0);
+
+/**
+ * @brief Get the number of the calling thread in the trace, numbered in
+ * the order threads first record a span.
+ */
+static uint32_t threadNumber()
+{
+    thread_local uint32_t number = ++traceThreads;
+    return number;
+}
+
+Trace::Span::Span(const char* name, const char* category)
+    : name(name), category(category), startUs(0), open(isEnabled())
+{
+    if (open) startUs = now();
+}
+
+Trace::Span::~Span()
+{
+    end();
+}
+
+void Trace::Span::end()
+{
+    if (!open) return;
+    open = false;
+    complete(name, category, startUs, now() - startUs);
+}
+
+void Trace::start(const std::string& path)
+{
+    if (traceEnabled) return;
+    tracePath = path;
+    traceEpoch = std::chrono::steady_clock::now();
+    traceEnabled = true;
+    std::atexit(write);
+}
+
+bool Trace::isEnabled()
+{
+    return traceEnabled.load(std::memory_order_relaxed);
+}
+
+double Trace::now()
+{
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - traceEpoch).count();
+}
+
+void Trace::complete(const std::string& name, const char* category, double startUs, double durationUs)
+{
+    if (!isEnabled()) return;
+    uint32_t thread = threadNumber();
+    std::lock_guard<std::mutex> lock(traceMutex);
+    if (!isEnabled()) return; // written while waiting for the lock
+    traceEvents.push_back(TraceEvent{name, category, startUs, durationUs, thread});
+}
+
+void Trace::write()
+{
+    // threads still running at exit stop recording once it is written
+    std::lock_guard<std::mutex> lock(traceMutex);
+    traceEnabled = false;
+    std::ofstream file(tracePath);
+    file << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n";
+    char line[128];
+    for (size_t i = 0; i < traceEvents.size(); i++)
+    {
+        const TraceEvent& event = traceEvents[i];
+        snprintf(line, sizeof(line), "\", \"ph\": \"X\", \"ts\": %.3f, \"dur\": %.3f, \"pid\": 1, \"tid\": %u}",
+            event.startUs, event.durationUs, event.thread);
+        file << "{\"name\": \"" << event.name << "\", \"cat\": \"" << event.category << line
+            << ((i + 1 < traceEvents.size()) ? ",\n" : "\n");
+    }
+    file << "]}\n";
+    if (!file.good()) std::cerr << "Could not write trace file " << tracePath << "\n";
+}
@@ -8,8 +8,10 @@
 */
 
 #include "TuiManager.hpp"
+#include "Trace.hpp"
 #include <boost/algorithm/string.hpp>
 #include <boost/regex.hpp>
+#include <fstream>
 
 TuiManager::TuiManager() 
 {
@@ -19,21 +21,53 @@ TuiManager::TuiManager()
     raw();
     noecho();
     keypad(stdscr, TRUE);
+    set_escdelay(25);
 
     // set up ncurses colors
     init_pair(COLOR_ERROR, COLOR_WHITE, COLOR_RED);
     init_pair(COLOR_INFO, COLOR_BLUE, COLOR_WHITE);
     init_pair(COLOR_BOLD, COLOR_BLUE, COLOR_GREEN);
+    init_pair(COLOR_DIFF, COLOR_WHITE, COLOR_MAGENTA);
     
     // initialize height and width
     getmaxyx(stdscr, height, width);
+
+    parser = nullptr;
+    menuTop = nullptr;
+    menuPad = nullptr;
+    tablePad = nullptr;
+    selectionVersion = 0;
+    queryVersion = 0;
+    diffParser = nullptr;
+    diffSelectionVersion = -1;
+    diffUnmatched = 0;
+    deltaTime = 0;
+    deltaStep = NO_DELTA_STEP;
+    parsingAtLastInput = true;
 }
 
 TuiManager::~TuiManager() 
 {
+    if (menuPad) delwin(menuPad);
+    if (tablePad) delwin(tablePad);
     endwin();
 }
 
+void TuiManager::ensurePad(WINDOW*& pad, size_t rows, size_t cols) 
+{
+    rows = std::max(rows, (size_t)1);
+    cols = std::max(cols, (size_t)1);
+    if (!pad) 
+    {
+        pad = newpad(rows, cols);
+        return;
+    }
+    size_t currRows, currCols;
+    getmaxyx(pad, currRows, currCols);
+    if (currRows != rows || currCols != cols) 
+        wresize(pad, rows, cols);
+}
+
 void TuiManager::displayBottomLine(attr_t attr, const char* str, ...) 
 {
     attrset(attr);
@@ -44,6 +78,67 @@ void TuiManager::displayBottomLine(attr_t attr, const char* str, ...)
     va_end(args);
 }
 
+int TuiManager::getInput() 
+{
+    // poll while parsing so progress keeps updating; the screen was drawn
+    // before this call, so poll once more after parsing finishes in case it
+    // was drawn while the parser was still running
+    bool parsing = (parser && !parser->isDone()) || (diffParser && !diffParser->isDone());
+    timeout((parsing || parsingAtLastInput) ? 100 : -1);
+    parsingAtLastInput = parsing;
+    return getch();
+}
+
+std::string TuiManager::progressString() 
+{
+    if (!parser || parser->isDone()) return "";
+    uint64_t bytes = parser->getBytesRead();
+    uint64_t total = std::max(parser->getTotalBytes(), (uint64_t)1);
+    double seconds = parser->getParseSeconds();
+    double rate = (seconds > 0) ? bytes / seconds : 0;
+    size_t filled = std::min(bytes * 20 / total, (uint64_t)20);
+
+    char buf[128];
+    snprintf(buf, sizeof(buf), "[%s%s] %3d%% %.1f/%.1f MB %.1f MB/s ETA ",
+        std::string(filled, '#').c_str(), std::string(20 - filled, '.').c_str(),
+        (int)(bytes * 100 / total), bytes / 1e6, total / 1e6, rate / 1e6);
+    std::string progress(buf);
+    if (rate > 0) 
+        progress += std::to_string((uint64_t)((total - std::min(bytes, total)) / rate)) + "s";
+    else 
+        progress += "?";
+    return progress;
+}
+
+void TuiManager::displayStartup() 
+{
+    while (1) 
+    {
+        std::vector<std::string> report = parser->getReport();
+        move(0, 0);
+        attrset(A_NORMAL);
+        for (auto& line : report) 
+        {
+            printw("%s", line.c_str());
+            clrtoeol();
+            printw("\n\r");
+        }
+
+        clearBottomLine();
+        if (parser->isDefinitionsDone()) 
+            displayBottomLine(DISPLAY_INFO, "ENTER to continue %s", progressString().c_str());
+        else 
+            displayBottomLine(DISPLAY_INFO, "Parsing definitions %s", progressString().c_str());
+        refresh();
+
+        int c = getInput();
+        if (c == KEY_RESIZE) 
+            resize();
+        else if (c == '\n' && parser->isDefinitionsDone()) 
+            return;
+    }
+}
+
 void TuiManager::clearBottomLine() 
 {
     move(height - 2, 0);
@@ -54,46 +149,248 @@ void TuiManager::clearBottomLine()
 
 void TuiManager::printMenu() 
 {
-    WINDOW *w;
-    w = newpad(300, width);
-    scrollok(w, TRUE);
-    for (auto& menuItem : visibleMenuItems) 
+    Trace::Span frameSpan("printMenu", "ui");
+    Trace::Span formatSpan("format", "ui");
+    size_t numLines = (height > 2) ? height - 2 : 0;
+
+    // center the cursor by walking back half a screen from it
+    MenuPos rowPos = cursorPos;
+    for (size_t i = 0; i < numLines / 2 && menuPrev(rowPos); i++);
+
+    // format only the rows inside the viewport
+    std::vector<Cell> lines;
+    lines.reserve(numLines);
+    bool more = true;
+    for (size_t i = 0; i < numLines && more; i++, more = menuNext(rowPos)) 
     {
+        VcdNode* node = menuNode(rowPos);
+        Cell line;
         // set attribute
-        if (cursorPos->node == menuItem.node) 
-            wattrset(w, DISPLAY_INFO);
-        else if (selected.count(menuItem.node->getName())) 
-            wattrset(w, DISPLAY_SELECTED);
+        if (rowPos == cursorPos) 
+            line.attr = DISPLAY_INFO;
+        else if (selected.count(node->getName())) 
+            line.attr = DISPLAY_SELECTED;
         else 
-            wattrset(w, A_NORMAL);
+            line.attr = A_NORMAL;
+
+        char marker = ' ';
+        if (node->getType() == VcdNode::SCOPE || node->getType() == VcdNode::ARR_SCOPE) 
+            marker = expanded.count(node) ? 'v' : '>';
+        line.text = std::string(std::max(3 * (int)rowPos.size() - 1, 0), ' ') + marker + ' ' + node->getName();
+        if (line.text.size() >= width) line.text.resize(width - 1);
+        lines.push_back(line);
+    }
+    formatSpan.end();
+
+    Trace::Span drawSpan("ncurses", "ui");
+    printMenuLines(lines);
+}
+
+void TuiManager::printMenuLines(std::vector<Cell>& lines) 
+{
+    size_t numLines = (height > 2) ? height - 2 : 0;
+
+    // rewrite only lines that changed since the last frame, clearing the
+    // rest of the screen
+    lines.resize(numLines, Cell{"", A_NORMAL});
+    ensurePad(menuPad, numLines, width);
+    for (size_t i = 0; i < numLines; i++) 
+    {
+        if (i < menuLines.size() && lines[i] == menuLines[i]) continue;
+        wmove(menuPad, i, 0);
+        wattrset(menuPad, A_NORMAL);
+        wclrtoeol(menuPad);
+        wattrset(menuPad, lines[i].attr);
+        waddstr(menuPad, lines[i].text.c_str());
+    }
+    menuLines.swap(lines);
+
+    if (numLines > 0) 
+        prefresh(menuPad, 0, 0, 0, 0, numLines - 1, width - 1);
+}
+
+void TuiManager::displaySearch() 
+{
+    SignalIndex& index = parser->getIndex();
+    std::string searchQuery;
+    std::vector<SignalIndex::Id> results;
+    size_t total = 0;
+    size_t resultPos = 0;
+    bool changed = true;
+    int c;
+
+    // control loop
+    while(1) 
+    {
+        size_t numLines = (height > 2) ? height - 2 : 0;
+        if (changed) 
+        {
+            results = index.search(searchQuery, numLines, &total);
+            resultPos = 0;
+            changed = false;
+        }
+
+        // show the ranked results in place of the menu
+        std::vector<Cell> lines;
+        for (size_t i = 0; i < results.size() && i < numLines; i++) 
+        {
+            Cell line;
+            line.text = index.getPath(results[i]);
+            if (line.text.size() >= width) line.text = line.text.substr(line.text.size() - width + 1);
+            if (i == resultPos) 
+                line.attr = DISPLAY_INFO;
+            else if (selected.count(index.getNode(results[i])->getName())) 
+                line.attr = DISPLAY_SELECTED;
+            else 
+                line.attr = A_NORMAL;
+            lines.push_back(line);
+        }
+
+        clearBottomLine();
+        displayBottomLine(DISPLAY_INFO, "%zu matches. ENTER to go to match, ESC to cancel.", total);
+        attrset(A_NORMAL);
+        mvprintw(height - 2, 0, "/%s", searchQuery.c_str());
+        refresh();
+        printMenuLines(lines);
+        move(height - 2, searchQuery.size() + 1);
 
-        // print
-        if (menuItem.node->getType() == VcdNode::SCOPE || menuItem.node->getType() == VcdNode::ARR_SCOPE) 
-            wprintw(w, "\n\r% *c %s", 3 * menuItem.level, menuItem.expanded ? 'v' : '>', menuItem.node->getName().c_str());
-        else // var
-            wprintw(w, "\n\r% *c %s", 3 * menuItem.level, ' ', menuItem.node->getName().c_str());
+        switch((c = getInput())) 
+        {
+        case ERR:
+            break;
+        case KEY_UP:
+            if (resultPos > 0) resultPos--;
+            break;
+        case KEY_DOWN:
+            if (resultPos + 1 < results.size()) resultPos++;
+            break;
+        case '\n':
+            if (!results.empty()) reveal(results[resultPos]);
+            return;
+        case 27: // ESC
+            return;
+        case KEY_BACKSPACE:
+        case 127:
+        case '\b':
+            if (searchQuery.empty()) return;
+            searchQuery.pop_back();
+            changed = true;
+            break;
+        case KEY_RESIZE:
+            resize();
+            changed = true;
+            break;
+        default:
+            if (c < 256 && isprint(c)) 
+            {
+                searchQuery += (char)c;
+                changed = true;
+            }
+            break;
+        }
+    }
+}
+
+void TuiManager::reveal(SignalIndex::Id id) 
+{
+    SignalIndex& index = parser->getIndex();
+    std::vector<SignalIndex::Id> chain;
+    for (; id != SignalIndex::NONE; id = index.getParent(id)) 
+    {
+        chain.push_back(id);
+    }
+
+    // walk down from the top scope, expanding every scope on the way
+    cursorPos.clear();
+    for (size_t i = chain.size() - 1; i > 0; i--) 
+    {
+        VcdScope* scope = dynamic_cast<VcdScope*>(index.getNode(chain[i]));
+        expand(scope);
+        cursorPos.push_back(scope->getChildren().find(index.getNode(chain[i - 1])->getName()));
     }
+}
+
+VcdNode* TuiManager::menuNode(const MenuPos& pos) 
+{
+    return pos.empty() ? menuTop : pos.back()->second;
+}
 
-    // determine vertical position of pad based on cursor position
-    size_t verticalPos = std::distance(visibleMenuItems.begin(), cursorPos);
+VcdScope* TuiManager::menuParent(const MenuPos& pos, size_t level) 
+{
+    return (level <= 1) ? menuTop : dynamic_cast<VcdScope*>(pos[level - 2]->second);
+}
+
+bool TuiManager::menuNext(MenuPos& pos) 
+{
+    // descend into an expanded scope
+    VcdNode* node = menuNode(pos);
+    if (expanded.count(node)) 
+    {
+        auto& children = dynamic_cast<VcdScope*>(node)->getChildren();
+        if (!children.empty()) 
+        {
+            pos.push_back(children.begin());
+            return true;
+        }
+    }
+    // otherwise move to the next sibling of the closest ancestor that has one
+    size_t level = pos.size();
+    while (level > 0) 
+    {
+        auto next = std::next(pos[level - 1]);
+        if (next != menuParent(pos, level)->getChildren().end()) 
+        {
+            pos.resize(level);
+            pos.back() = next;
+            return true;
+        }
+        level--;
+    }
+    return false;
+}
 
-    if (verticalPos < ((height - 3) / 2))
-        verticalPos = 0;
-    else
-        verticalPos = verticalPos - ((height - 3) / 2);
+bool TuiManager::menuPrev(MenuPos& pos) 
+{
+    if (pos.empty()) return false;
+    // move to the parent if this is the first child
+    if (pos.back() == menuParent(pos, pos.size())->getChildren().begin()) 
+    {
+        pos.pop_back();
+        return true;
+    }
+    // otherwise move to the last visible row under the previous sibling
+    --pos.back();
+    while (expanded.count(menuNode(pos))) 
+    {
+        auto& children = dynamic_cast<VcdScope*>(menuNode(pos))->getChildren();
+        if (children.empty()) break;
+        pos.push_back(std::prev(children.end()));
+    }
+    return true;
+}
 
-    prefresh(w, verticalPos, 0, 0, 0, height - 3, width);
+void TuiManager::menuLast(MenuPos& pos) 
+{
+    pos.clear();
+    while (expanded.count(menuNode(pos))) 
+    {
+        auto& children = dynamic_cast<VcdScope*>(menuNode(pos))->getChildren();
+        if (children.empty()) break;
+        pos.push_back(std::prev(children.end()));
+    }
 }
 
 void TuiManager::displayMenuMode(VcdScope* top) 
 {
     // initialize by expanding just the top scope
-    if (visibleMenuItems.empty()) 
+    if (!menuTop) 
     {
-        visibleMenuItems.emplace_back(MenuItem(top, 0));
-        expand(visibleMenuItems.begin());
-        cursorPos = visibleMenuItems.begin();
+        menuTop = top;
+        expand(top);
+        cursorPos.clear();
     }
+    // the screen was cleared since the menu was last shown
+    if (menuPad) touchwin(menuPad);
 
     int c;
     bool err = false;
@@ -110,38 +407,36 @@ void TuiManager::displayMenuMode(VcdScope* top)
         } 
         else 
         {
-            displayBottomLine(DISPLAY_INFO, "%d selected. ENTER to continue.\n\r", selected.size());
+            displayBottomLine(DISPLAY_INFO, "%d selected. ENTER to continue. %s\n\r", selected.size(), progressString().c_str());
         }
         refresh();
         printMenu();
         move(height - 2, 0);
         attrset(A_NORMAL);
 
-        switch((c = getch())) 
+        switch((c = getInput())) 
         {
+        case ERR:
+            break;
         case KEY_UP:
         case 'k':
-            if (cursorPos == visibleMenuItems.begin()) 
-                cursorPos = std::prev(visibleMenuItems.end());
-            else
-                --cursorPos;
+            if (!menuPrev(cursorPos)) 
+                menuLast(cursorPos);
             break;
         case KEY_DOWN:
         case 'j':
-            if (cursorPos == std::prev(visibleMenuItems.end()))
-                cursorPos = visibleMenuItems.begin();
-            else
-                ++cursorPos;
+            if (!menuNext(cursorPos))
+                cursorPos.clear();
             break;
         case ' ':
             // only allow expand VcdScope or VcdArrScope
-            if ((cursorPos->node->getType() == VcdNode::SCOPE) 
-             || (cursorPos->node->getType() == VcdNode::ARR_SCOPE)) 
+            if ((menuNode(cursorPos)->getType() == VcdNode::SCOPE) 
+             || (menuNode(cursorPos)->getType() == VcdNode::ARR_SCOPE)) 
             {
-                if (cursorPos->expanded)
-                    collapse(cursorPos);
+                if (expanded.count(menuNode(cursorPos)))
+                    collapse(menuNode(cursorPos));
                 else
-                    expand(cursorPos);
+                    expand(menuNode(cursorPos));
             } 
             else 
             {
@@ -150,13 +445,14 @@ void TuiManager::displayMenuMode(VcdScope* top)
             break;
         case 's':
             // only allow select VcdVar or VcdArrScope
-            if ((cursorPos->node->getType() == VcdNode::VAR) 
-             || (cursorPos->node->getType() == VcdNode::ARR_SCOPE))
+            if ((menuNode(cursorPos)->getType() == VcdNode::VAR) 
+             || (menuNode(cursorPos)->getType() == VcdNode::ARR_SCOPE))
             {
-                if (selected.count(cursorPos->node->getName()))
-                    selected.erase(cursorPos->node->getName());
+                if (selected.count(menuNode(cursorPos)->getName()))
+                    selected.erase(menuNode(cursorPos)->getName());
                 else
-                    selected[cursorPos->node->getName()] = dynamic_cast<VcdPrimitive*>(cursorPos->node);
+                    selected[menuNode(cursorPos)->getName()] = dynamic_cast<VcdPrimitive*>(menuNode(cursorPos));
+                selectionVersion++;
             } 
             else 
             {
@@ -165,6 +461,13 @@ void TuiManager::displayMenuMode(VcdScope* top)
             break;
         case 'C':
             selected.clear();
+            selectionVersion++;
+            break;
+        case '/':
+            displaySearch();
+            break;
+        case KEY_RESIZE:
+            resize();
             break;
         case '\n':
             return;
@@ -185,27 +488,59 @@ void TuiManager::displayTableMode()
     lined = false;
     highlightIdx = -1;
     timestamp = 0;
+    rowOffset = 0;
+    colOffset = 0;
+    frame.valid = false;
+    stepDirection = 0;
+    deltaStep = NO_DELTA_STEP;
     bool err = false;
+    std::string errMessage;
+    std::string info;
 
     // control loop
     while(1)
     {
         c = 0;
 
+        maxTime = parser->getMaxTime();
+        if (diffParser && !diffParser->isDone()) 
+            maxTime = std::min(maxTime, (uint64_t)diffParser->getMaxTime());
+        matchDiffSignals();
+        // moving to another time leaves the delta cycles
+        if (timestamp != deltaTime) deltaStep = NO_DELTA_STEP;
+
         clearBottomLine();
         if (err) 
         {
-            displayBottomLine(DISPLAY_ERROR, "Command not recognized.");
+            displayBottomLine(DISPLAY_ERROR, "%s", errMessage.empty() ? "Command not recognized." : errMessage.c_str());
             err = false;
+            errMessage.clear();
+        } 
+        else if (!info.empty()) 
+        {
+            displayBottomLine(DISPLAY_INFO, "%s", info.c_str());
+            info.clear();
         } 
+        else if (deltaStep != NO_DELTA_STEP) 
+        {
+            displayBottomLine(DISPLAY_INFO, "%s", deltaStepString().c_str());
+        } 
+        else if (!parser->isDone() || (diffParser && !diffParser->isDone())) 
+        {
+            displayBottomLine(DISPLAY_INFO, "Parsed up to t = %llu %s %s", 
+                maxTime * timescaleMultiplier, timescaleUnit.c_str(), progressString().c_str());
+        }
         refresh();
         printTable();
         move(height - 2, 0);
         attrset(A_NORMAL);
 
         char str[50];
-        switch((c = getch())) 
+        char definition[256];
+        switch((c = getInput())) 
         {
+        case ERR:
+            break;
         case KEY_UP:
         case 'k':
             highlightIdx = (highlightIdx == 0) ? maxSelectedSize - 1 : highlightIdx - 1;
@@ -217,29 +552,119 @@ void TuiManager::displayTableMode()
         case KEY_LEFT:
         case 'h':
             if (timestamp > 0) timestamp--;
+            stepDirection = -1;
             break;
         case KEY_RIGHT:
         case 'l':
             if (timestamp < maxTime) timestamp++;
+            stepDirection = 1;
+            break;
+        case KEY_SLEFT:
+        case 'H':
+            if (colOffset > 0) colOffset--;
+            break;
+        case KEY_SRIGHT:
+        case 'L':
+            if (colOffset + 1 < selected.size()) colOffset++;
             break;
         case 't':
             lined = !lined;
             break;
+        case KEY_RESIZE:
+            resize();
+            break;
         case ':':
+            timeout(-1);
             getstr(str);
             sscanf(str, "%llu", &timestamp);
             timestamp = timestamp / timescaleMultiplier;
             if (timestamp > maxTime) timestamp = maxTime;
+            stepDirection = 0;
             break;
         case '/':
+            timeout(-1);
             getstr(str);
             sscanf(str, "%llu", &highlightIdx);
             if (highlightIdx > maxSelectedSize - 1) highlightIdx = -1;
             break;
         case '?':
+            timeout(-1);
             getstr(str);
             err = !parseQuery(std::string(str));
             break;
+        case 'S':
+            displayStats();
+            erase();
+            frame.valid = false;
+            break;
+        case 'V':
+            timeout(-1);
+            getstr(str);
+            err = !displayLifetimes(boost::trim_copy(std::string(str)), errMessage);
+            erase();
+            frame.valid = false;
+            break;
+        case 'E':
+            timeout(-1);
+            getnstr(definition, sizeof(definition) - 1);
+            err = !exportColumns(std::string(definition), info, errMessage);
+            break;
+        case '=':
+            timeout(-1);
+            getnstr(definition, sizeof(definition) - 1);
+            err = !defineColumn(std::string(definition), errMessage);
+            break;
+        case 'D':
+        case 'n':
+            if (diffParser && !diffError.empty()) 
+            {
+                info = "Cannot compare the waveforms: " + diffError + ".";
+            } 
+            else if (diffParser) 
+            {
+                // first divergence, or next one after the current time
+                uint64_t t = (c == 'D') 
+                    ? waveformDiff.findDivergence(0, true, maxTime) 
+                    : waveformDiff.findDivergence(timestamp, false, maxTime);
+                if (t == WaveformDiff::NONE) 
+                {
+                    info = "No divergence found up to t = " 
+                        + std::to_string(maxTime * timescaleMultiplier) + " " + timescaleUnit + ".";
+                } 
+                else 
+                {
+                    timestamp = t;
+                    stepDirection = 0;
+                }
+            } 
+            else 
+            {
+                err = true;
+            }
+            break;
+        case '<':
+        case '>':
+            if (deltaStep == NO_DELTA_STEP && !startDeltaSteps()) 
+            {
+                info = "No delta cycles at t = " + std::to_string(timestamp * timescaleMultiplier) + " " + timescaleUnit + ".";
+                break;
+            }
+            if (c == '<' && deltaStep > 0) deltaStep--;
+            if (c == '>' && deltaStep < deltaEvents.size()) deltaStep++;
+            break;
+        case 'g':
+        {
+            uint64_t t = parser->getNextDeltaTime(timestamp);
+            if (t == (uint64_t)-1 || t > maxTime) 
+            {
+                info = "No delta cycles after t = " + std::to_string(timestamp * timescaleMultiplier) + " " + timescaleUnit + ".";
+                break;
+            }
+            timestamp = t;
+            stepDirection = 0;
+            startDeltaSteps();
+            break;
+        }
         case 'Q':
             return;
         default:
@@ -250,9 +675,421 @@ void TuiManager::displayTableMode()
     }
 }
 
+bool TuiManager::startDeltaSteps() 
+{
+    deltaEvents = parser->getDeltaEvents(timestamp);
+    if (deltaEvents.empty()) return false;
+    deltaTime = timestamp;
+    deltaStep = deltaEvents.size();
+    return true;
+}
+
+std::string TuiManager::deltaStepString() 
+{
+    std::string prefix = "Delta cycle " + std::to_string(deltaStep) + " of " + std::to_string(deltaEvents.size()) 
+        + " at t = " + std::to_string(deltaTime * timescaleMultiplier) + " " + timescaleUnit;
+    if (deltaStep == 0) return prefix + ": before any change (< >: step)";
+    const DeltaEvent& event = deltaEvents[deltaStep - 1];
+    SignalIndex& index = parser->getIndex();
+    std::shared_lock<std::shared_mutex> lock(parser->getValuesMutex());
+    return prefix + ": " + index.getPath(index.getId(event.var)) + " = " + event.var->getRawValueOf(event.value) 
+        + " (was " + event.var->getRawValueOf(event.previous) + ")";
+}
+
+void TuiManager::applyDeltaStep(FrameCache::Frame& values, const FrameCache::Columns& columns, size_t start, size_t count) 
+{
+    // value of each var changed at deltaTime after the applied events, or
+    // before its first event that is not applied, by the store of the var
+    std::unordered_map<VcdStore*, const std::string*> stepValues;
+    for (size_t i = 0; i < deltaEvents.size(); i++) 
+    {
+        if (i < deltaStep) 
+            stepValues[deltaEvents[i].var->getStore()] = &deltaEvents[i].value;
+        else 
+            stepValues.emplace(deltaEvents[i].var->getStore(), &deltaEvents[i].previous);
+    }
+    for (auto& col : columns) 
+    {
+        if (col.second->getType() == VcdNode::VAR) 
+        {
+            VcdVar* var = dynamic_cast<VcdVar*>(col.second);
+            auto it = stepValues.find(var->getStore());
+            if (it != stepValues.end()) values[col.first] = var->getValueWindowOf(*it->second, start, count);
+        }
+        else if (col.second->getType() == VcdNode::ARR_SCOPE) 
+        {
+            VcdArrScope* array = dynamic_cast<VcdArrScope*>(col.second);
+            for (size_t row = 0; row < count && start + row < array->getSize(); row++) 
+            {
+                VcdVar* element = array->getElement(start + row);
+                auto it = element ? stepValues.find(element->getStore()) : stepValues.end();
+                if (it != stepValues.end()) values[col.first][row] = element->getRawValueOf(*it->second);
+            }
+        }
+    }
+}
+
+void TuiManager::matchDiffSignals() 
+{
+    if (!diffParser || !diffParser->isDefinitionsDone() || diffSelectionVersion == selectionVersion) return;
+    SignalIndex& index = parser->getIndex();
+    SignalIndex& diffIndex = diffParser->getIndex();
+    diffSelected.clear();
+    diffUnmatched = 0;
+    std::vector<std::pair<VcdPrimitive*, VcdPrimitive*>> pairs;
+
+    // "1 ns" and "1ns" are the same timescale
+    std::string timescale = boost::erase_all_copy(parser->getTimescale(), " ");
+    std::string diffTimescale = boost::erase_all_copy(diffParser->getTimescale(), " ");
+    if (diffTimescale != timescale) 
+    {
+        diffError = "diff timescale " + diffParser->getTimescale() + " differs from " + parser->getTimescale();
+        waveformDiff.setPairs(pairs);
+        diffSelectionVersion = selectionVersion;
+        frame.valid = false;
+        return;
+    }
+    for (auto& var : selected) 
+    {
+        if (var.second->getType() == VcdNode::DERIVED) continue;
+        SignalIndex::Id id = index.getId(var.second);
+        VcdNode* match = (id == SignalIndex::NONE) ? nullptr : diffIndex.find(index.getPath(id));
+        VcdPrimitive* primitive = match ? dynamic_cast<VcdPrimitive*>(match) : nullptr;
+        if (!primitive) 
+        {
+            diffUnmatched++;
+            continue;
+        }
+        diffSelected[var.first] = primitive;
+        pairs.emplace_back(var.second, primitive);
+    }
+    diffUnmatched += waveformDiff.setPairs(pairs);
+    diffSelectionVersion = selectionVersion;
+    frame.valid = false;
+}
+
+void TuiManager::displayStats() 
+{
+    clearBottomLine();
+    displayBottomLine(DISPLAY_INFO, "Computing activity...");
+    refresh();
+    ActivityStats stats;
+    stats.setValuesMutex(&parser->getValuesMutex());
+    stats.compute(FrameCache::Columns(selected.begin(), selected.end()), maxTime);
+    const std::vector<ActivityStats::Signal>& signals = stats.getSignals();
+    size_t maxSize = 0;
+    for (auto& signal : signals) 
+    {
+        maxSize = std::max(maxSize, signal.toggles.size());
+    }
+    double duration = (double)stats.getEndTime() + 1;
+
+    size_t first = 0;     // first index shown
+    size_t sigOffset = 0; // first signal shown in the index table
+    int c;
+    // control loop
+    while (1) 
+    {
+        erase();
+        attrset(DISPLAY_BOLD);
+        mvprintw(0, 0, "Activity from t = 0 to %llu %s (%zu signals in %.1f ms)", 
+            (unsigned long long)(stats.getEndTime() * timescaleMultiplier), timescaleUnit.c_str(), signals.size(), stats.getSeconds() * 1e3);
+        clrtoeol();
+
+        // occupancy of each signal
+        attrset(A_NORMAL);
+        mvprintw(2, 0, "%24s | %14s | %14s | %14s |", "signal", "peak occupancy", "peak at t", "avg occupancy");
+        size_t y = 3;
+        for (size_t s = 0; s < signals.size() && y < height - 4; s++, y++) 
+        {
+            mvprintw(y, 0, "%24.24s | %14llu | %14llu | %14.2f |", signals[s].name.c_str(), 
+                (unsigned long long)signals[s].peakOccupancy, 
+                (unsigned long long)(signals[s].peakTime * timescaleMultiplier), signals[s].averageOccupancy);
+        }
+
+        // toggles and time active of each index
+        y++;
+        move(y++, 0);
+        printw(" index |");
+        std::vector<size_t> colWidths;
+        size_t totalWidth = 8;
+        for (size_t s = sigOffset; s < signals.size(); s++) 
+        {
+            size_t colWidth = std::max(signals[s].name.size() + 9, (size_t)16);
+            if (!colWidths.empty() && totalWidth + 2 * colWidth + 4 > width) break;
+            colWidths.push_back(colWidth);
+            totalWidth += 2 * colWidth + 4;
+            printw("%*s |%*s |", (int)colWidth, (signals[s].name + " toggles").c_str(), 
+                (int)colWidth, (signals[s].name + " active%").c_str());
+        }
+        size_t numRows = (height > y + 2) ? height - 2 - y : 0;
+        if (maxSize > numRows && first > maxSize - numRows) first = maxSize - numRows;
+        for (size_t i = first; i < maxSize && i < first + numRows; i++, y++) 
+        {
+            move(y, 0);
+            attrset(DISPLAY_BOLD | A_NORMAL);
+            printw("%6zu |", i);
+            attrset(A_NORMAL);
+            for (size_t col = 0; col < colWidths.size(); col++) 
+            {
+                const ActivityStats::Signal& signal = signals[sigOffset + col];
+                if (i < signal.toggles.size()) 
+                    printw("%*llu |%*.2f |", (int)colWidths[col], (unsigned long long)signal.toggles[i], 
+                        (int)colWidths[col], signal.activeTime[i] * 100 / duration);
+                else 
+                    printw("%*s |%*s |", (int)colWidths[col], "", (int)colWidths[col], "");
+            }
+        }
+
+        clearBottomLine();
+        displayBottomLine(DISPLAY_INFO, "j/k to scroll indices, H/L to scroll signals, Q to return.");
+        refresh();
+
+        switch ((c = getInput())) 
+        {
+        case KEY_DOWN:
+        case 'j':
+            if (first + 1 < maxSize) first++;
+            break;
+        case KEY_UP:
+        case 'k':
+            if (first > 0) first--;
+            break;
+        case KEY_SLEFT:
+        case 'H':
+            if (sigOffset > 0) sigOffset--;
+            break;
+        case KEY_SRIGHT:
+        case 'L':
+            if (sigOffset + 1 < signals.size()) sigOffset++;
+            break;
+        case KEY_RESIZE:
+            resize();
+            break;
+        case 'Q':
+            return;
+        default:
+            break;
+        }
+    }
+}
+
+bool TuiManager::displayLifetimes(std::string name, std::string& error) 
+{
+    if (!selected.count(name)) 
+    {
+        error = "No selected signal " + name + ".";
+        return false;
+    }
+    VcdVar* var = dynamic_cast<VcdVar*>(selected[name]);
+    if (var && var->getValueKind() != VcdVar::VECTOR) 
+    {
+        error = name + " is not a bit vector.";
+        return false;
+    }
+    clearBottomLine();
+    displayBottomLine(DISPLAY_INFO, "Computing lifetimes...");
+    refresh();
+    LifetimeTracker tracker;
+    tracker.setValuesMutex(&parser->getValuesMutex());
+    tracker.compute(selected[name], maxTime);
+    const std::vector<LifetimeTracker::Lifetime>& lifetimes = tracker.getLifetimes();
+    std::vector<std::pair<uint64_t, size_t>> histogram = tracker.getHistogram();
+    size_t maxCount = 0;
+    for (auto& bin : histogram) 
+    {
+        maxCount = std::max(maxCount, bin.second);
+    }
+
+    size_t first = 0;  // first lifetime shown
+    size_t cursor = 0; // lifetime under the cursor
+    int c;
+    // control loop
+    while (1) 
+    {
+        erase();
+        attrset(DISPLAY_BOLD);
+        mvprintw(0, 0, "Lifetimes of %s from t = 0 to %llu %s (%zu lifetimes, %zu still allocated, in %.1f ms)", 
+            name.c_str(), (unsigned long long)(tracker.getEndTime() * timescaleMultiplier), timescaleUnit.c_str(), lifetimes.size(), 
+            lifetimes.size() - tracker.getClosedCount(), tracker.getSeconds() * 1e3);
+        clrtoeol();
+
+        // latency of released entries
+        attrset(A_NORMAL);
+        mvprintw(2, 0, "%10s | %10s | %10s | %10s | %10s | %10s | (%s)", "min", "mean", "p50", "p90", "p99", "max", 
+            timescaleUnit.c_str());
+        mvprintw(3, 0, "%10llu | %10.1f | %10llu | %10llu | %10llu | %10llu |", 
+            (unsigned long long)(tracker.getPercentile(0) * timescaleMultiplier), tracker.getMean() * timescaleMultiplier, 
+            (unsigned long long)(tracker.getPercentile(50) * timescaleMultiplier), 
+            (unsigned long long)(tracker.getPercentile(90) * timescaleMultiplier), 
+            (unsigned long long)(tracker.getPercentile(99) * timescaleMultiplier), 
+            (unsigned long long)(tracker.getPercentile(100) * timescaleMultiplier));
+        size_t y = 5;
+        size_t barWidth = (width > 44) ? width - 44 : 1;
+        for (size_t b = 0; b < histogram.size() && y < height / 2; b++, y++) 
+        {
+            size_t bar = maxCount ? (histogram[b].second * barWidth + maxCount - 1) / maxCount : 0;
+            mvprintw(y, 0, "%12llu - %-12llu |%10zu | %s", (unsigned long long)(histogram[b].first * timescaleMultiplier), 
+                (unsigned long long)((2 * histogram[b].first - 1) * timescaleMultiplier), histogram[b].second, std::string(bar, '#').c_str());
+        }
+
+        // longest-lived entries
+        y++;
+        attrset(DISPLAY_BOLD);
+        mvprintw(y++, 0, "%6s | %14s | %14s | %14s |", "index", "allocated at t", "released at t", "lifetime");
+        size_t numRows = (height > y + 2) ? height - 2 - y : 0;
+        if (cursor < first) first = cursor;
+        if (numRows && cursor >= first + numRows) first = cursor - numRows + 1;
+        for (size_t i = first; i < lifetimes.size() && i < first + numRows; i++, y++) 
+        {
+            const LifetimeTracker::Lifetime& lifetime = lifetimes[i];
+            attrset((i == cursor) ? DISPLAY_SELECTED : A_NORMAL);
+            if (lifetime.open) 
+                mvprintw(y, 0, "%6zu | %14llu | %14s | %13llu+ |", lifetime.index, 
+                    (unsigned long long)(lifetime.start * timescaleMultiplier), "-", 
+                    (unsigned long long)(lifetime.length() * timescaleMultiplier));
+            else 
+                mvprintw(y, 0, "%6zu | %14llu | %14llu | %14llu |", lifetime.index, 
+                    (unsigned long long)(lifetime.start * timescaleMultiplier), 
+                    (unsigned long long)(lifetime.end * timescaleMultiplier), 
+                    (unsigned long long)(lifetime.length() * timescaleMultiplier));
+        }
+
+        attrset(A_NORMAL);
+        clearBottomLine();
+        displayBottomLine(DISPLAY_INFO, "j/k to move, ENTER to jump to the entry in the table, Q to return.");
+        refresh();
+
+        switch ((c = getInput())) 
+        {
+        case KEY_DOWN:
+        case 'j':
+            if (cursor + 1 < lifetimes.size()) cursor++;
+            break;
+        case KEY_UP:
+        case 'k':
+            if (cursor > 0) cursor--;
+            break;
+        case KEY_RESIZE:
+            resize();
+            break;
+        case '\n':
+            if (cursor < lifetimes.size()) 
+            {
+                timestamp = lifetimes[cursor].start;
+                highlightIdx = lifetimes[cursor].index;
+                stepDirection = 0;
+            }
+            return true;
+        case 'Q':
+            return true;
+        default:
+            break;
+        }
+    }
+}
+
+bool TuiManager::exportColumns(std::string command, std::string& info, std::string& error) 
+{
+    Exporter::Options options{Exporter::CSV, 0, maxTime, 0, nullptr, timescaleMultiplier, timescaleUnit};
+    std::string path, clockName;
+    if (!Exporter::parseCommand(command, options, path, clockName, error)) return false;
+    if (!clockName.empty()) 
+    {
+        if (!selected.count(clockName)) 
+        {
+            error = "No selected signal " + clockName + ".";
+            return false;
+        }
+        options.clock = selected[clockName];
+    }
+    if (options.endTime > maxTime) options.endTime = maxTime;
+    std::ofstream out(path, std::ios::binary);
+    if (!out.good()) 
+    {
+        error = "Could not open " + path + ".";
+        return false;
+    }
+
+    clearBottomLine();
+    displayBottomLine(DISPLAY_INFO, "Exporting to %s...", path.c_str());
+    refresh();
+    Exporter exporter;
+    exporter.setValuesMutex(&parser->getValuesMutex());
+    exporter.setColumns(FrameCache::Columns(selected.begin(), selected.end()));
+    if (!exporter.write(out, options)) 
+    {
+        error = exporter.getError();
+        return false;
+    }
+    info = "Exported " + std::to_string(exporter.getRows()) + " rows to " + path + " in " 
+        + std::to_string(exporter.getSeconds()) + " s.";
+    return true;
+}
+
+bool TuiManager::defineColumn(std::string definition, std::string& error) 
+{
+    auto sep = definition.find('=');
+    std::string name = (sep == std::string::npos) ? "" : boost::trim_copy(definition.substr(0, sep));
+    std::string expression = (sep == std::string::npos) ? "" : boost::trim_copy(definition.substr(sep + 1));
+    if (name.empty() || name.find_first_of(" &|^~=!()") != std::string::npos) 
+    {
+        error = "Usage: =<name> = <expression>";
+        return false;
+    }
+    if (selected.count(name) && !derived.count(name)) 
+    {
+        error = name + " is already a selected signal.";
+        return false;
+    }
+    if (derived.count(name)) 
+    {
+        // columns using this one would keep using the old definition
+        for (auto& other : derived) 
+        {
+            if (other.second->uses(derived[name])) 
+            {
+                error = name + " is used by " + other.first + ".";
+                return false;
+            }
+        }
+    }
+
+    // an empty expression removes the column
+    if (expression.empty()) 
+    {
+        if (!derived.count(name)) 
+        {
+            error = "No derived column " + name + ".";
+            return false;
+        }
+        derived.erase(name);
+        selected.erase(name);
+        query.erase(name);
+        selectionVersion++;
+        queryVersion++;
+        return true;
+    }
+
+    std::map<std::string, VcdPrimitive*> available = selected;
+    available.erase(name);
+    std::unique_ptr<DerivedColumn> column(new DerivedColumn(name));
+    if (!column->parse(expression, available)) 
+    {
+        error = "Invalid expression: " + column->getError();
+        return false;
+    }
+    derived[name] = column.get();
+    selected[name] = column.get();
+    derivedColumns.push_back(std::move(column));
+    selectionVersion++;
+    return true;
+}
+
 bool TuiManager::parseQuery(std::string query_str) 
 {
     query.clear();
+    queryVersion++;
     std::vector<std::string> result;
     boost::split(result, query_str, boost::is_any_of("&"));
     for (auto& q : result) 
@@ -265,8 +1102,13 @@ bool TuiManager::parseQuery(std::string query_str)
         std::string val_str = q.substr(sep + 1, q.size());
         if (key.size() == 0 || val_str.size() == 0) goto err;
 
+        std::vector<std::string> alternatives;
+        boost::split(alternatives, val_str, boost::is_any_of("|"));
         std::set<std::string> vals;
-        boost::split(vals, val_str, boost::is_any_of("|"));
+        for (auto& alternative : alternatives) 
+        {
+            vals.insert(VcdVar::queryValue(selected[key], alternative));
+        }
         query[key] = vals;
     }
 
@@ -279,105 +1121,249 @@ bool TuiManager::parseQuery(std::string query_str)
 
 void TuiManager::printTable() 
 {
+    Trace::Span frameSpan("printTable", "ui");
     maxSelectedSize = 0;
+    for (auto& var : selected) 
+    {
+        if (var.second->getSize() > maxSelectedSize) maxSelectedSize = var.second->getSize();
+    }
+    if (colOffset >= selected.size()) colOffset = selected.empty() ? 0 : selected.size() - 1;
+
+    // determine the window of rows that fits on the screen
+    size_t rowHeight = lined ? 2 : 1;
+    size_t firstRowY = lined ? 4 : 3;
+    size_t visibleRows = (height > firstRowY + 2) ? (height - 2 - firstRowY) / rowHeight : 0;
+    if (highlightIdx == (uint64_t)-1 || highlightIdx < visibleRows / 2) 
+        rowOffset = 0;
+    else 
+        rowOffset = highlightIdx - visibleRows / 2;
+    if (maxSelectedSize <= visibleRows) 
+        rowOffset = 0;
+    else if (rowOffset > maxSelectedSize - visibleRows) 
+        rowOffset = maxSelectedSize - visibleRows;
+    size_t numRows = std::min(visibleRows, maxSelectedSize - rowOffset);
+
+    // determine the window of columns that fits on the screen
+    std::vector<std::map<std::string, VcdPrimitive*>::iterator> cols;
     std::vector<size_t> colWidths;
-    std::map<std::string, std::vector<std::string>> values;
     size_t totalWidth = 8;
-    attrset(DISPLAY_BOLD);
-    move(0, 0);
-    printw("t = %llu %s \n\n\r", timestamp * timescaleMultiplier, timescaleUnit.c_str());
-    printw(" index |");
+    for (auto it = std::next(selected.begin(), colOffset); it != selected.end(); ++it) 
+    {
+        size_t colWidth = it->second->getWidth();
+        if (!cols.empty() && totalWidth + colWidth + 2 > width) break;
+        cols.push_back(it);
+        colWidths.push_back(std::min(colWidth, width > 10 ? width - 10 : 1));
+        totalWidth += colWidths.back() + 2;
+    }
 
-    // determine widths of columns and print table header
-    for (auto& var : selected) 
+    // nothing to do if the frame on screen was built from the same state
+    bool sameLayout = frame.valid
+        && frame.selectionVersion == selectionVersion
+        && frame.rowOffset == rowOffset
+        && frame.colOffset == colOffset
+        && frame.numRows == numRows
+        && frame.height == height
+        && frame.width == width
+        && frame.lined == lined
+        && frame.colWidths == colWidths;
+    if (sameLayout
+        && frame.timestamp == timestamp
+        && frame.queryVersion == queryVersion
+        && frame.highlightIdx == highlightIdx
+        && frame.deltaStep == deltaStep) 
     {
-        size_t width = var.second->getWidth();
-        colWidths.push_back(width);
-        totalWidth += width + 2;
-        printw("% *s |", width, var.first.c_str());
-        if (var.second->getSize() > maxSelectedSize) maxSelectedSize = var.second->getSize();
+        return;
     }
 
-    // retrieve values for all vars
-    for (auto& var : selected) 
+    // retrieve values of the visible window and of any queried columns from the
+    // frame cache, then let it prefetch the neighbouring timestamps
+    FrameCache::Columns frameCols;
+    for (auto& col : cols) 
+    {
+        frameCols.emplace_back(col->first, col->second);
+    }
+    for (auto& q : query) 
+    {
+        if (std::find(cols.begin(), cols.end(), selected.find(q.first)) == cols.end()) 
+            frameCols.emplace_back(q.first, selected[q.first]);
+    }
+    Trace::Span fetchSpan("fetch values", "ui");
+    frameCache.setWindow(frameCols, rowOffset, numRows);
+    std::shared_ptr<const FrameCache::Frame> values = frameCache.get(timestamp);
+    frameCache.prefetch(timestamp, stepDirection, maxTime);
+    if (deltaStep != NO_DELTA_STEP) 
     {
-        values[var.first] = var.second->getValueAt(timestamp, maxSelectedSize);
+        auto stepped = std::make_shared<FrameCache::Frame>(*values);
+        applyDeltaStep(*stepped, frameCols, rowOffset, numRows);
+        values = stepped;
     }
 
-    WINDOW *w;
-    int padHeight = maxSelectedSize * 2 + 3;
-    w = newpad(padHeight, width);
-    scrollok(w, TRUE);
+    // retrieve the same window of the matching signals of the second waveform
+    std::shared_ptr<const FrameCache::Frame> diffValues;
+    if (!diffSelected.empty()) 
+    {
+        FrameCache::Columns diffCols;
+        for (auto& col : cols) 
+        {
+            auto match = diffSelected.find(col->first);
+            if (match != diffSelected.end()) diffCols.emplace_back(match->first, match->second);
+        }
+        diffFrameCache.setWindow(diffCols, rowOffset, numRows);
+        diffValues = diffFrameCache.get(timestamp);
+        diffFrameCache.prefetch(timestamp, stepDirection, maxTime);
+    }
 
-    if (lined) printw("\n\r%s", std::string(totalWidth, '=').c_str());
-    printw("\n\r");
+    fetchSpan.end();
 
-    // print table rows
-    for (size_t i = 0; i < maxSelectedSize; i++) 
+    // format table rows
+    Trace::Span formatSpan("format", "ui");
+    std::vector<std::vector<Cell>> cells(numRows);
+    char buf[16];
+    for (size_t row = 0; row < numRows; row++) 
     {
+        size_t i = rowOffset + row;
         bool query_match = (query.size() > 0);
         for (auto& q : query) 
         {
-            if (!q.second.count(values[q.first].at(i))) 
+            if (!q.second.count(values->at(q.first).at(row))) 
             {
                 query_match = false;
                 break;
             }
         }
-        std::string hl = "";
-        wattrset(w, DISPLAY_BOLD | A_NORMAL);
-        if (query_match) wattrset(w, DISPLAY_SELECTED);
-        if (i == highlightIdx) wattrset(w, DISPLAY_INFO);
-        wprintw(w, "% 6d |", i);
-        size_t col = 0;
-        wattrset(w, A_NORMAL);
-        if (query_match) wattrset(w, DISPLAY_SELECTED);
-        if (i == highlightIdx) wattrset(w, DISPLAY_INFO);
-        for (auto& val : values) 
-        {
-            wprintw(w, "% *s |", colWidths.at(col), val.second.at(i).c_str());
-            col++;
+        attr_t indexAttr = DISPLAY_BOLD | A_NORMAL;
+        attr_t valueAttr = A_NORMAL;
+        if (query_match) indexAttr = valueAttr = DISPLAY_SELECTED;
+        if (i == highlightIdx) indexAttr = valueAttr = DISPLAY_INFO;
+        snprintf(buf, sizeof(buf), "%6zu |", i);
+        cells[row].reserve(cols.size() + 1);
+        cells[row].push_back(Cell{buf, indexAttr});
+        for (auto& col : cols) 
+        {
+            const std::string& value = values->at(col->first).at(row);
+            attr_t attr = valueAttr;
+            if (diffValues && diffValues->count(col->first) && diffValues->at(col->first).at(row) != value) 
+                attr = DISPLAY_DIFF;
+            cells[row].push_back(Cell{value, attr});
         }
-        
-        if (lined) wprintw(w, "\n\r%s", std::string(totalWidth, '-').c_str());
-        wprintw(w, "\n\r");
     }
 
-    // determine vertical position of pad based on cursor selection
-    size_t verticalPos = (highlightIdx == (uint64_t)-1) ? 0 : highlightIdx + (lined * highlightIdx + 1);
-    if (verticalPos < ((height - 3) / 2)) 
-        verticalPos = 0;
-    else 
-        verticalPos = verticalPos - ((height - 3) / 2);
-    prefresh(w, verticalPos, 0, 4, 0, height - 3, width);
-}
+    formatSpan.end();
 
-void TuiManager::expand(std::list<TuiManager::MenuItem>::iterator scope_itr) 
-{
-    assert(!scope_itr->expanded);
-    assert(scope_itr->node->getType() == VcdNode::SCOPE 
-        || scope_itr->node->getType() == VcdNode::ARR_SCOPE);
-    auto curr_itr = std::next(scope_itr);
-    for (auto& child : dynamic_cast<VcdScope*>(scope_itr->node)->getChildren()) 
+    // print table header
+    Trace::Span drawSpan("ncurses", "ui");
+    attrset(DISPLAY_BOLD);
+    move(0, 0);
+    printw("t = %llu %s", (unsigned long long)(timestamp * timescaleMultiplier), timescaleUnit.c_str());
+    if (cols.size() < selected.size()) 
+        printw("  (columns %zu-%zu of %zu)", colOffset + 1, colOffset + cols.size(), selected.size());
+    if (diffParser && !diffError.empty()) 
+        printw("  (%s)", diffError.c_str());
+    else if (diffParser && diffUnmatched > 0) 
+        printw("  (%zu selected not in diff)", diffUnmatched);
+    clrtoeol();
+    if (!sameLayout) 
     {
-        visibleMenuItems.insert(curr_itr, MenuItem(child.second, scope_itr->level + 1));
+        move(2, 0);
+        printw(" index |");
+        for (size_t col = 0; col < cols.size(); col++) 
+        {
+            printw("%*.*s |", (int)colWidths.at(col), (int)colWidths.at(col), cols.at(col)->first.c_str());
+        }
+        clrtoeol();
+        move(3, 0);
+        if (lined) printw("%s", std::string(std::min(totalWidth, width), '=').c_str());
+        clrtoeol();
+
+        ensurePad(tablePad, visibleRows * rowHeight, width);
+        werase(tablePad);
     }
-    scope_itr->expanded = true;
-    scope_itr->lastChild = curr_itr;
+    // flush the header first so it cannot overwrite the pad on the next refresh
+    wnoutrefresh(stdscr);
+
+    // print only the cells that differ from the frame on screen
+    for (size_t row = 0; row < numRows; row++) 
+    {
+        size_t x = 0;
+        for (size_t col = 0; col < cells[row].size(); col++) 
+        {
+            const Cell& cell = cells[row][col];
+            size_t cellWidth = (col == 0) ? 8 : colWidths.at(col - 1) + 2;
+            if (!sameLayout || !(frame.cells[row][col] == cell)) 
+            {
+                wmove(tablePad, row * rowHeight, x);
+                wattrset(tablePad, cell.attr);
+                if (col == 0)
+                    waddstr(tablePad, cell.text.c_str());
+                else
+                    wprintw(tablePad, "%*.*s |", (int)(cellWidth - 2), (int)(cellWidth - 2), cell.text.c_str());
+            }
+            x += cellWidth;
+        }
+        if (!sameLayout && lined) 
+        {
+            wattrset(tablePad, A_NORMAL);
+            mvwprintw(tablePad, row * rowHeight + 1, 0, "%s", std::string(std::min(totalWidth, width), '-').c_str());
+        }
+    }
+
+    if (visibleRows > 0) 
+        prefresh(tablePad, 0, 0, firstRowY, 0, height - 3, width - 1);
+
+    frame.valid = true;
+    frame.timestamp = timestamp;
+    frame.selectionVersion = selectionVersion;
+    frame.queryVersion = queryVersion;
+    frame.highlightIdx = highlightIdx;
+    frame.deltaStep = deltaStep;
+    frame.rowOffset = rowOffset;
+    frame.colOffset = colOffset;
+    frame.numRows = numRows;
+    frame.height = height;
+    frame.width = width;
+    frame.lined = lined;
+    frame.colWidths.swap(colWidths);
+    frame.cells.swap(cells);
+}
+
+void TuiManager::resize() 
+{
+    getmaxyx(stdscr, height, width);
+    erase();
+    // force full redraws into the resized pads
+    frame.valid = false;
+    menuLines.clear();
+    if (menuPad) werase(menuPad);
+}
+
+void TuiManager::expand(VcdNode* scope) 
+{
+    assert(scope->getType() == VcdNode::SCOPE 
+        || scope->getType() == VcdNode::ARR_SCOPE);
+    expanded.insert(scope);
+}
+
+void TuiManager::collapse(VcdNode* scope) 
+{
+    assert(scope->getType() == VcdNode::SCOPE 
+        || scope->getType() == VcdNode::ARR_SCOPE);
+    expanded.erase(scope);
 }
 
-void TuiManager::collapse(std::list<TuiManager::MenuItem>::iterator scope_itr) 
+void TuiManager::setParser(Waveform* parser) 
 {
-    assert(scope_itr->expanded);
-    assert(scope_itr->node->getType() == VcdNode::SCOPE 
-        || scope_itr->node->getType() == VcdNode::ARR_SCOPE);
-    visibleMenuItems.erase(std::next(scope_itr), scope_itr->lastChild);
-    scope_itr->expanded = false;
+    this->parser = parser;
+    maxTime = parser->getMaxTime();
+    frameCache.setValuesMutex(&parser->getValuesMutex());
 }
 
-void TuiManager::setMaxTime(uint64_t time) 
+void TuiManager::setDiffParser(Parser* parser) 
 {
-    maxTime = time;
+    diffParser = parser;
+    diffSelectionVersion = -1;
+    parsingAtLastInput = true;
+    diffFrameCache.setValuesMutex(&parser->getValuesMutex());
+    waveformDiff.setValuesMutexes(&this->parser->getValuesMutex(), &parser->getValuesMutex());
 }
 
 void TuiManager::setTimescale(std::string timescale) 
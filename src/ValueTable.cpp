@@ -0,0 +1,79 @@
+/**
+ * Author:          Cynthia Wang
+ * Date created:    10/19/2026
+ * Organization:    ECE 4122
+ *
+ * Description:
+ * Source file for ValueTable class and functions. See ValueTable.hpp for function descriptions.
+*/
+
+#include "ValueTable.hpp"
+
+#include <functional>
+
+size_t ValueTable::getEntryBytes(const std::string& value)
+{
+    // a hash table node holds the next pointer, the entry and the cached hash
+    const size_t nodeBytes = 2 * sizeof(void*) + sizeof(std::pair<const std::string_view, uint32_t>);
+    size_t bytes = sizeof(std::string) + nodeBytes;
+    if (value.capacity() > std::string().capacity()) bytes += value.capacity() + 1;
+    return bytes;
+}
+
+uint32_t ValueTable::intern(const std::string& value, size_t& addedBytes)
+{
+    size_t hash = std::hash<std::string_view>()(value);
+    size_t shardIdx = hash % NUM_SHARDS;
+    Shard& shard = shards[shardIdx];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    addedBytes = 0;
+    auto it = shard.ids.find(value);
+    if (it != shard.ids.end()) return it->second;
+    if (shard.values.size() >= (MAX_IDS >> SHARD_BITS)) return NONE;
+    uint32_t id = (uint32_t)((shard.values.size() << SHARD_BITS) | shardIdx);
+    shard.values.push_back(value);
+    shard.ids.emplace(shard.values.back(), id);
+    addedBytes = getEntryBytes(shard.values.back());
+    return id;
+}
+
+const std::string& ValueTable::lookup(uint32_t id)
+{
+    return shards[id % NUM_SHARDS].values[id >> SHARD_BITS];
+}
+
+size_t ValueTable::size()
+{
+    size_t count = 0;
+    for (auto& shard : shards)
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        count += shard.values.size();
+    }
+    return count;
+}
+
+size_t ValueTable::getMemoryBytes()
+{
+    size_t bytes = getOverheadBytes();
+    for (auto& shard : shards)
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        for (auto& value : shard.values)
+        {
+            bytes += getEntryBytes(value);
+        }
+    }
+    return bytes;
+}
+
+size_t ValueTable::getOverheadBytes()
+{
+    size_t bytes = 0;
+    for (auto& shard : shards)
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        bytes += shard.ids.bucket_count() * sizeof(void*);
+    }
+    return bytes;
+}
@@ -8,8 +8,13 @@
 */
 
 #include "Vcd.hpp"
-#include <iomanip>
+#include <algorithm>
 #include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+// width of the column of a real or string var, whose values have no fixed size
+#define TYPED_VALUE_WIDTH 16
 
 const std::string VcdNode::getName() 
 {
@@ -26,20 +31,200 @@ const std::map<std::string, VcdNode*>& VcdScope::getChildren()
     return children;
 }
 
+VcdVar::ValueKind VcdVar::getValueKind() 
+{
+    return valueKind;
+}
+
 size_t VcdVar::getSize() 
 {
-    return size;
+    return (valueKind == VECTOR) ? size : 1;
+}
+
+VcdVar::ValueKind VcdVar::kindOfType(const std::string& type) 
+{
+    if (type == "real" || type == "realtime" || type == "shortreal") return REAL;
+    if (type == "string") return STRING;
+    return VECTOR;
+}
+
+std::string VcdVar::formatReal(double value) 
+{
+    if (std::isnan(value)) return "x";
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%.15g", value);
+    if (strtod(buf, nullptr) != value) snprintf(buf, sizeof(buf), "%.17g", value);
+    return buf;
+}
+
+std::string VcdVar::displayTyped(const std::string& value) 
+{
+    if (!value.empty() && (value[0] == 'r' || value[0] == 'R')) 
+    {
+        // canonical form, as stored, for values straight from the file
+        char* end;
+        double real = strtod(value.c_str() + 1, &end);
+        return (end != value.c_str() + 1 && *end == '\0') ? formatReal(real) : value.substr(1);
+    }
+    if (!value.empty() && (value[0] == 's' || value[0] == 'S')) 
+        return value.substr(1);
+    return value;
+}
+
+std::string VcdVar::queryValue(VcdPrimitive* primitive, const std::string& value) 
+{
+    VcdVar* var = dynamic_cast<VcdVar*>(primitive);
+    if (!var || var->getValueKind() != REAL) return value;
+    char* end;
+    double real = strtod(value.c_str(), &end);
+    return (end != value.c_str() && *end == '\0') ? formatReal(real) : value;
+}
+
+void VcdStore::appendTypedValue(uint64_t time, const std::string& value) 
+{
+    // only the last of several changes at the same time is kept
+    if (!changeTimes.empty() && changeTimes.back() == time) 
+    {
+        changeTimes.pop_back();
+        if (valueKind == VcdVar::REAL) 
+            realValues.pop_back();
+        else 
+            stringIds.pop_back();
+    }
+    if (valueKind == VcdVar::REAL) 
+    {
+        double real = (value.size() > 1 && (value[0] == 'r' || value[0] == 'R')) ? strtod(value.c_str() + 1, nullptr) : NAN;
+        // compare bits so NaNs are equal
+        if (!realValues.empty() && memcmp(&realValues.back(), &real, sizeof(real)) == 0) return;
+        changeTimes.push_back(time);
+        realValues.push_back(real);
+    }
+    else 
+    {
+        auto it = stringIndex.emplace(VcdVar::displayTyped(value), strings.size()).first;
+        if (it->second == strings.size()) strings.push_back(it->first);
+        if (!stringIds.empty() && stringIds.back() == it->second) return;
+        changeTimes.push_back(time);
+        stringIds.push_back(it->second);
+    }
+}
+
+/**
+ * @brief Check if a value of a 1-bit var toggles to its complement.
+ */
+static bool isBit(char value) 
+{
+    return value == '0' || value == '1';
+}
+
+void VcdStore::appendTransition(uint64_t time, const std::string& str) 
+{
+    if (!transitionTimes.empty() && time <= transitionTimes.back()) return;
+    if (size > 1) 
+    {
+        size_t addedBytes;
+        uint32_t id = valueTable->intern(str, addedBytes);
+        internedBytes += addedBytes;
+        if (id == ValueTable::NONE) 
+        {
+            auto it = stringIndex.emplace(str, strings.size()).first;
+            if (it->second == strings.size()) strings.push_back(str);
+            id = OWN_VALUE | it->second;
+        }
+        if (!transitionIds.empty() && transitionIds.back() == id) return;
+        transitionIds.push_back(id);
+        transitionTimes.push_back(time);
+        return;
+    }
+    char value = str.back();
+    if (!transitionTimes.empty()) 
+    {
+        char previous = transitionBitAt(transitionTimes.size() - 1);
+        if (value == previous) return;
+        if (isBit(value) && isBit(previous)) 
+        {
+            transitionTimes.push_back(time);
+            return;
+        }
+    }
+    transitionValues.emplace_back(transitionTimes.size(), value);
+    transitionTimes.push_back(time);
+}
+
+char VcdStore::transitionBitAt(size_t pos) 
+{
+    // the last stored value at or before pos, toggled once per transition since
+    auto it = std::upper_bound(transitionValues.begin(), transitionValues.end(), pos,
+        [](size_t p, const std::pair<size_t, char>& stored) 
+        {
+            return p < stored.first;
+        }
+    );
+    --it;
+    if ((pos - it->first) % 2 == 0) return it->second;
+    return (it->second == '0') ? '1' : '0';
+}
+
+const std::string VcdStore::transitionValueAt(size_t pos) 
+{
+    if (size > 1) 
+    {
+        uint32_t id = transitionIds[pos];
+        return (id & OWN_VALUE) ? strings[id & ~OWN_VALUE] : valueTable->lookup(id);
+    }
+    return std::string(1, transitionBitAt(pos));
+}
+
+const std::string VcdStore::typedValueAt(size_t pos) 
+{
+    if (valueKind == VcdVar::REAL) 
+        return std::isnan(realValues[pos]) ? "x" : 'r' + VcdVar::formatReal(realValues[pos]);
+    return 's' + strings[stringIds[pos]];
+}
+
+const std::string VcdStore::valueAt(uint64_t time) 
+{
+    if (valueKind != VcdVar::VECTOR) 
+    {
+        auto it = std::upper_bound(changeTimes.begin(), changeTimes.end(), time);
+        if (it == changeTimes.begin()) return "x"; // before the first change
+        return typedValueAt(it - changeTimes.begin() - 1);
+    }
+    if (hasLastValue && time >= lastValue.first) return lastValue.second;
+    size_t pos = transitionTimes.upperBound(time);
+    if (pos == 0) return (size > 1) ? "bx" : "x"; // before the first change
+    return transitionValueAt(pos - 1);
 }
 
 const std::vector<std::string> VcdVar::getValueAt(uint64_t time, size_t vec_size) 
+{
+    return getValueWindow(time, 0, vec_size);
+}
+
+const std::vector<std::string> VcdVar::getValueWindow(uint64_t time, size_t start, size_t count) 
+{
+    return getValueWindowOf(valueAt(time), start, count);
+}
+
+const std::vector<std::string> VcdVar::getValueWindowOf(const std::string& value, size_t start, size_t count) 
 {
     std::vector<std::string> value_vec;
-    std::string value_str = intervalValues(time);
+    value_vec.reserve(count);
+    if (valueKind != VECTOR) 
+    {
+        // a single row
+        for (size_t i = start; i < start + count; i++) 
+        {
+            value_vec.emplace_back((i == 0) ? displayTyped(value) : " ");
+        }
+        return value_vec;
+    }
+    std::string value_str = value;
     if (this->size > 1) 
     {
         value_str = value_str.substr(1, value_str.size()); // remove 'b' prefix
     }
-    for (size_t i = 0; i < vec_size; i++) 
+    for (size_t i = start; i < start + count; i++) 
     {
         if (i < value_str.size()) 
         {
@@ -60,31 +245,226 @@ const std::vector<std::string> VcdVar::getValueAt(uint64_t time, size_t vec_size
 // done at runtime to take care of 'x' case
 const std::string VcdVar::getRawValueAt(uint64_t time) 
 {
-    std::string bin_val = intervalValues(time);
-    bin_val = bin_val.substr(1, bin_val.size());
-    std::ostringstream stringStream;
-    if (size > 1) 
+    return getRawValueOf(valueAt(time));
+}
+
+const std::string VcdVar::getRawValueOf(const std::string& value) 
+{
+    std::string bin_val = value;
+    if (valueKind != VECTOR) return displayTyped(bin_val);
+    if (bin_val.at(0) == 'b') 
     {
-        stringStream << 'h' << std::hex << std::setw(ceil(size / 4.0));
-        if (bin_val.at(0) == 'x') 
-        { // fill with x if x
-            stringStream << std::setfill('x') << 'x';
-        } 
-        else 
-        { // pad with 0 otherwise
-            uint64_t val = std::stoull(bin_val, nullptr, 2);
-            stringStream << std::setfill('0') << val;
+        bin_val = bin_val.substr(1, bin_val.size()); // remove 'b' prefix
+    }
+    if (size <= 1) 
+    {
+        return 'h' + bin_val;
+    }
+    // extend to whole hex digits with x or z if the value starts with one,
+    // and with 0 otherwise, then convert each digit so any width works
+    size_t digits = std::max((size_t)ceil(size / 4.0), (bin_val.size() + 3) / 4);
+    char fill = (bin_val.at(0) == 'x' || bin_val.at(0) == 'z') ? bin_val.at(0) : '0';
+    bin_val.insert(0, digits * 4 - bin_val.size(), fill);
+    std::string hex_val(digits + 1, 'h');
+    for (size_t d = 0; d < digits; d++) 
+    {
+        unsigned nibble = 0;
+        char unknown = 0;
+        for (size_t b = 0; b < 4; b++) 
+        {
+            char c = bin_val.at(d * 4 + b);
+            if (c == '0' || c == '1') 
+                nibble = (nibble << 1) | (c - '0');
+            else 
+                unknown = (unknown != 'x' && (c == 'z' || c == 'Z')) ? 'z' : 'x';
         }
-    } 
-    else 
-    { // size == 1
-        stringStream << 'h' << bin_val;
+        hex_val[d + 1] = unknown ? unknown : "0123456789abcdef"[nibble];
     }
-    return stringStream.str();
+    return hex_val;
+}
+
+uint64_t VcdStore::getNextChange(uint64_t time) 
+{
+    if (valueKind != VcdVar::VECTOR) 
+    {
+        auto it = std::upper_bound(changeTimes.begin(), changeTimes.end(), time);
+        return (it == changeTimes.end()) ? (uint64_t)-1 : *it;
+    }
+    if (hasLastValue && time >= lastValue.first) return (uint64_t)-1;
+    // changes to the same value are not stored, so every transition is a change
+    size_t pos = transitionTimes.upperBound(time);
+    if (pos < transitionTimes.size()) return transitionTimes.at(pos);
+    return hasLastValue ? lastValue.first : (uint64_t)-1;
+}
+
+bool VcdStore::forEachValue(uint64_t startTime, uint64_t endTime, const std::function<bool(uint64_t, uint64_t, const std::string&)>& fn) 
+{
+    if (valueKind != VcdVar::VECTOR) 
+    {
+        // from the change in effect at startTime
+        size_t i = std::upper_bound(changeTimes.begin(), changeTimes.end(), startTime) - changeTimes.begin();
+        for (i = i ? i - 1 : 0; i < changeTimes.size() && changeTimes[i] <= endTime; i++) 
+        {
+            uint64_t end = (i + 1 < changeTimes.size()) ? std::min(changeTimes[i + 1], endTime + 1) : endTime + 1;
+            if (!fn(changeTimes[i], end, typedValueAt(i))) return false;
+        }
+        return true;
+    }
+    if (hasLastValue && lastValue.first <= startTime) 
+        return lastValue.first > endTime || fn(lastValue.first, endTime + 1, lastValue.second);
+    // each transition ends at the next one, or at lastValue
+    size_t after = transitionTimes.upperBound(startTime);
+    bool started = false;
+    uint64_t start = 0;
+    std::string value;
+    bool ended = false;
+    bool stopped = false;
+    transitionTimes.forEach(
+        [&](size_t pos, uint64_t time) 
+        {
+            if (started && !fn(start, std::min(time, endTime + 1), value)) 
+            {
+                stopped = true;
+                return false;
+            }
+            if (time > endTime) 
+            {
+                ended = true;
+                return false;
+            }
+            started = true;
+            start = time;
+            value = transitionValueAt(pos);
+            return true;
+        },
+        after ? after - 1 : 0
+    );
+    if (stopped) return false;
+    if (ended) return true;
+    if (started && !fn(start, hasLastValue ? std::min(lastValue.first, endTime + 1) : endTime + 1, value)) 
+        return false;
+    if (hasLastValue && lastValue.first <= endTime) 
+        return fn(lastValue.first, endTime + 1, lastValue.second);
+    return true;
+}
+
+char VcdVar::bitAt(const std::string& value, size_t i) 
+{
+    size_t first = (!value.empty() && value[0] == 'b') ? 1 : 0;
+    size_t len = value.size() - first;
+    if (i < len) return value[value.size() - 1 - i];
+    if (len == 0) return 'x';
+    char msb = value[first];
+    return (msb == 'x' || msb == 'X' || msb == 'z' || msb == 'Z') ? msb : '0';
+}
+
+/**
+ * @brief Get the bytes a string allocates beyond the object itself, which
+ * is nothing for a string short enough to be stored inline.
+ */
+static size_t heapBytes(const std::string& str) 
+{
+    return (str.capacity() > std::string().capacity()) ? str.capacity() + 1 : 0;
+}
+
+size_t VcdStore::getChangeCount() 
+{
+    return transitionTimes.size() + changeTimes.size() + vcdValues.size()
+        + (hasLastValue ? 1 : 0);
+}
+
+size_t VcdStore::getMemoryBytes() 
+{
+    // nodes of a doubly linked list carry two pointers
+    const size_t listNodeBytes = 2 * sizeof(void*);
+
+    size_t bytes = sizeof(VcdStore) + heapBytes(lastValue.second);
+    for (auto& value : vcdValues) 
+    {
+        bytes += listNodeBytes + sizeof(value) + heapBytes(value.second);
+    }
+    // values of vectors wider than 1 bit are shared in the ValueTable, and
+    // charged to the store that added them
+    bytes += transitionTimes.getMemoryBytes() + transitionValues.capacity() * sizeof(std::pair<size_t, char>)
+        + transitionIds.capacity() * sizeof(uint32_t) + internedBytes;
+
+    // columns of a real or string var, with the strings stored twice and
+    // a hash table node holding the next pointer and the cached hash
+    bytes += changeTimes.capacity() * sizeof(uint64_t) + realValues.capacity() * sizeof(double)
+        + stringIds.capacity() * sizeof(uint32_t) + strings.capacity() * sizeof(std::string)
+        + stringIndex.bucket_count() * sizeof(void*);
+    for (auto& str : strings) 
+    {
+        bytes += 2 * heapBytes(str) + 2 * sizeof(void*) + sizeof(std::pair<const std::string, uint32_t>);
+    }
+    return bytes;
+}
+
+const std::string VcdVar::valueAt(uint64_t time) 
+{
+    return store->valueAt(time);
+}
+
+uint64_t VcdVar::getNextChange(uint64_t time) 
+{
+    return store->getNextChange(time);
+}
+
+void VcdVar::forEachValue(uint64_t endTime, const std::function<void(uint64_t, uint64_t, const std::string&)>& fn) 
+{
+    store->forEachValue(0, endTime,
+        [&](uint64_t start, uint64_t end, const std::string& value) 
+        {
+            fn(start, end, value);
+            return true;
+        }
+    );
+}
+
+bool VcdVar::forEachValueFrom(uint64_t startTime, uint64_t endTime, const std::function<bool(uint64_t, uint64_t, const std::string&)>& fn) 
+{
+    return store->forEachValue(startTime, endTime, fn);
+}
+
+size_t VcdVar::getChangeCount() 
+{
+    return store ? store->getChangeCount() : 0;
+}
+
+size_t VcdVar::getMemoryBytes() 
+{
+    // the store shares its allocation with a control block of a vtable
+    // pointer and two counts
+    size_t bytes = sizeof(VcdVar) + heapBytes(name) + heapBytes(hash) + heapBytes(dimensions);
+    if (store) bytes += 3 * sizeof(void*) + store->getMemoryBytes();
+    return bytes;
+}
+
+VcdStore* VcdVar::getStore() 
+{
+    return store.get();
+}
+
+VcdAlias::VcdAlias(VcdVar* var) : VcdNode(VAR) 
+{
+    size = var->size;
+    valueKind = var->valueKind;
+    store = var->store;
+}
+
+size_t VcdAlias::getChangeCount() 
+{
+    return 0;
+}
+
+size_t VcdAlias::getMemoryBytes() 
+{
+    return sizeof(VcdAlias) + heapBytes(name) + heapBytes(hash) + heapBytes(dimensions);
 }
 
 size_t VcdVar::getWidth() 
 {
+    if (valueKind != VECTOR) return std::max(name.size() + 1, (size_t)TYPED_VALUE_WIDTH);
     return name.size() + 1;
 }
 
@@ -97,22 +477,41 @@ size_t VcdArrScope::getSize()
 size_t VcdArrScope::getWidth() 
 {
     // column width is max of value width and name width
-    return std::max(name.size() + 1, (size_t) ceil(dynamic_cast<VcdVar*>(children.begin()->second)->getSize() / 4.0) + 2);
+    VcdVar* element = dynamic_cast<VcdVar*>(children.begin()->second);
+    if (element->getValueKind() != VcdVar::VECTOR) return std::max(name.size() + 1, (size_t)TYPED_VALUE_WIDTH);
+    return std::max(name.size() + 1, (size_t) ceil(element->getSize() / 4.0) + 2);
 }
 
 const std::vector<std::string> VcdArrScope::getValueAt(uint64_t time, size_t size)
+{
+    return getValueWindow(time, 0, size);
+}
+
+const std::vector<std::string> VcdArrScope::getValueWindow(uint64_t time, size_t start, size_t count)
 {
     std::vector<std::string> value_vec;
-    size_t i = 0;
-    for (; i < children.size(); i++) 
+    value_vec.reserve(count);
+    for (size_t i = start; i < start + count; i++) 
     {
-        std::ostringstream stringStream;
-        stringStream << name << '[' << i << ']';
-        value_vec.emplace_back(dynamic_cast<VcdVar*>(children[stringStream.str()])->getRawValueAt(time));
+        if (i < elements.size() && elements[i]) 
+            value_vec.emplace_back(elements[i]->getRawValueAt(time));
+        else 
+            value_vec.emplace_back(" ");
     }
-    for (; i < size; i++) 
+    return value_vec;
+}
+
+VcdVar* VcdArrScope::getElement(size_t index)
+{
+    return (index < elements.size()) ? elements[index] : nullptr;
+}
+
+uint64_t VcdArrScope::getNextChange(uint64_t time)
+{
+    uint64_t next = (uint64_t)-1;
+    for (VcdVar* element : elements) 
     {
-        value_vec.emplace_back(" ");
+        if (element) next = std::min(next, element->getNextChange(time));
     }
-    return value_vec;
+    return next;
 }
\ No newline at end of file
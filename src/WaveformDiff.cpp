@@ -0,0 +1,107 @@
+/**
+ * Author:          Cynthia Wang
+ * Date created:    10/19/2026
+ * Organization:    ECE 4122
+ *
+ * Description:
+ * Source file for WaveformDiff class and functions. See WaveformDiff.hpp for function descriptions.
+*/
+
+#include "WaveformDiff.hpp"
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+
+void WaveformDiff::setValuesMutexes(std::shared_mutex* a, std::shared_mutex* b)
+{
+    mutexA = a;
+    mutexB = b;
+}
+
+size_t WaveformDiff::setPairs(const std::vector<std::pair<VcdPrimitive*, VcdPrimitive*>>& primitives)
+{
+    pairs.clear();
+    size_t skipped = 0;
+    for (auto& p : primitives)
+    {
+        if (p.first->getType() == VcdNode::VAR && p.second->getType() == VcdNode::VAR)
+        {
+            VcdVar* a = dynamic_cast<VcdVar*>(p.first);
+            VcdVar* b = dynamic_cast<VcdVar*>(p.second);
+            if (a->getSize() == b->getSize())
+            {
+                pairs.emplace_back(a, b);
+                continue;
+            }
+        }
+        else if (p.first->getType() == VcdNode::ARR_SCOPE && p.second->getType() == VcdNode::ARR_SCOPE)
+        {
+            // compare arrays element by element
+            VcdArrScope* a = dynamic_cast<VcdArrScope*>(p.first);
+            VcdArrScope* b = dynamic_cast<VcdArrScope*>(p.second);
+            if (a->elements.size() == b->elements.size())
+            {
+                for (size_t i = 0; i < a->elements.size(); i++)
+                {
+                    if (a->elements[i] && b->elements[i]
+                     && a->elements[i]->getSize() == b->elements[i]->getSize())
+                        pairs.emplace_back(a->elements[i], b->elements[i]);
+                }
+                continue;
+            }
+        }
+        skipped++;
+    }
+    return skipped;
+}
+
+std::string WaveformDiff::normalize(const std::string& value, size_t size)
+{
+    std::string bits = (!value.empty() && (value[0] == 'b' || value[0] == 'B')) ? value.substr(1) : value;
+    if (bits.size() >= size) return bits;
+    // vector values are extended with x or z if the leftmost bit is x or z,
+    // otherwise with 0
+    char fill = (!bits.empty() && (bits[0] == 'x' || bits[0] == 'X' || bits[0] == 'z' || bits[0] == 'Z')) ? bits[0] : '0';
+    return std::string(size - bits.size(), fill) + bits;
+}
+
+bool WaveformDiff::differ(VcdVar* a, VcdVar* b, uint64_t time)
+{
+    std::string valueA = a->valueAt(time);
+    std::string valueB = b->valueAt(time);
+    if (valueA == valueB) return false;
+    return normalize(valueA, a->getSize()) != normalize(valueB, b->getSize());
+}
+
+uint64_t WaveformDiff::findPair(VcdVar* a, VcdVar* b, uint64_t time, bool inclusive, uint64_t limit,
+    const std::atomic<uint64_t>& best)
+{
+    if (inclusive && differ(a, b, time)) return time;
+    // merge the change times of both vars, checking each one
+    uint64_t t = time;
+    while (1)
+    {
+        t = std::min(a->getNextChange(t), b->getNextChange(t));
+        if (t == NONE || t > limit || t >= best.load(std::memory_order_relaxed)) return NONE;
+        if (differ(a, b, t)) return t;
+    }
+}
+
+uint64_t WaveformDiff::findDivergence(uint64_t time, bool inclusive, uint64_t limit)
+{
+    std::shared_lock<std::shared_mutex> lockA, lockB;
+    if (mutexA) lockA = std::shared_lock<std::shared_mutex>(*mutexA);
+    if (mutexB) lockB = std::shared_lock<std::shared_mutex>(*mutexB);
+
+    std::atomic<uint64_t> best(NONE);
+    // the workers only read values while the calling thread holds the locks
+    ThreadPool::get().parallelFor(pairs.size(),
+        [&](size_t i, size_t)
+        {
+            uint64_t t = findPair(pairs[i].first, pairs[i].second, time, inclusive, limit, best);
+            uint64_t curr = best.load();
+            while (t < curr && !best.compare_exchange_weak(curr, t));
+        }
+    );
+    return best.load();
+}
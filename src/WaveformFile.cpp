@@ -0,0 +1,223 @@
+/**
+ * Author:          Cynthia Wang
+ * Date created:    10/19/2026
+ * Organization:    ECE 4122
+ *
+ * Description:
+ * Source file for WaveformFile class and functions. See WaveformFile.hpp for function descriptions.
+*/
+
+#include "WaveformFile.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <shared_mutex>
+#include <thread>
+
+#include "Parser.hpp"
+#include "RemoteWaveform.hpp"
+
+bool WaveformFile::open(const std::vector<std::string>& files)
+{
+    waveform.reset();
+    if (files.empty())
+    {
+        error = "No waveform file provided.";
+        return false;
+    }
+    for (auto& file : files)
+    {
+        if (!std::ifstream(file).good())
+        {
+            error = "Could not open waveform file " + file + ".";
+            return false;
+        }
+    }
+    Parser* parser = new Parser(files);
+    waveform.reset(parser);
+    parser->parse();
+    if (!parser->getTop())
+    {
+        waveform.reset();
+        error = "No definitions in " + files[0] + ".";
+        return false;
+    }
+    return true;
+}
+
+bool WaveformFile::open(const std::string& file)
+{
+    return open(std::vector<std::string>{file});
+}
+
+bool WaveformFile::connect(const std::string& socketPath)
+{
+    RemoteWaveform* remote = new RemoteWaveform();
+    waveform.reset(remote);
+    if (!remote->connect(socketPath, error))
+    {
+        waveform.reset();
+        return false;
+    }
+    while (!remote->isDone())
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+    return true;
+}
+
+const std::string& WaveformFile::getError()
+{
+    return error;
+}
+
+Waveform* WaveformFile::getWaveform()
+{
+    return waveform.get();
+}
+
+std::string WaveformFile::getTimescale()
+{
+    return waveform ? waveform->getTimescale() : "";
+}
+
+uint64_t WaveformFile::getEndTime()
+{
+    return waveform ? waveform->getMaxTime() : 0;
+}
+
+VcdPrimitive* WaveformFile::findPrimitive(const std::string& path)
+{
+    if (!waveform)
+    {
+        error = "No waveform is open.";
+        return nullptr;
+    }
+    VcdPrimitive* primitive = dynamic_cast<VcdPrimitive*>(waveform->getIndex().find(path));
+    if (!primitive) error = "No signal " + path + ".";
+    return primitive;
+}
+
+WaveformFile::Signal WaveformFile::describe(SignalIndex::Id id)
+{
+    SignalIndex& index = waveform->getIndex();
+    VcdNode* node = index.getNode(id);
+    VcdPrimitive* primitive = dynamic_cast<VcdPrimitive*>(node);
+    return Signal{index.getPath(id), node->getType(), primitive ? primitive->getSize() : 0};
+}
+
+bool WaveformFile::list(const std::string& scope, bool recursive, std::vector<Signal>& signals)
+{
+    signals.clear();
+    if (!waveform)
+    {
+        error = "No waveform is open.";
+        return false;
+    }
+    SignalIndex& index = waveform->getIndex();
+    SignalIndex::Id scopeId = SignalIndex::NONE;
+    if (!scope.empty())
+    {
+        VcdNode* node = index.find(scope);
+        if (!node || node->getType() == VcdNode::VAR)
+        {
+            error = "No scope " + scope + ".";
+            return false;
+        }
+        scopeId = index.getId(node);
+    }
+    for (SignalIndex::Id id = 0; id < index.size(); id++)
+    {
+        SignalIndex::Id parent = index.getParent(id);
+        bool listed = (parent == scopeId);
+        while (recursive && !listed && parent != SignalIndex::NONE)
+        {
+            parent = index.getParent(parent);
+            listed = (parent == scopeId);
+        }
+        if (listed) signals.push_back(describe(id));
+    }
+    return true;
+}
+
+std::vector<std::string> WaveformFile::search(const std::string& query, size_t limit)
+{
+    std::vector<std::string> paths;
+    if (!waveform) return paths;
+    SignalIndex& index = waveform->getIndex();
+    for (auto id : index.search(query, limit))
+    {
+        paths.push_back(index.getPath(id));
+    }
+    return paths;
+}
+
+bool WaveformFile::valueAt(const std::string& path, uint64_t time, std::vector<std::string>& values)
+{
+    VcdPrimitive* primitive = findPrimitive(path);
+    if (!primitive) return false;
+    std::shared_lock<std::shared_mutex> lock(waveform->getValuesMutex());
+    values = primitive->getValueWindow(time, 0, primitive->getSize());
+    return true;
+}
+
+bool WaveformFile::rawValueAt(const std::string& path, uint64_t time, std::string& value)
+{
+    VcdPrimitive* primitive = findPrimitive(path);
+    if (!primitive) return false;
+    VcdVar* var = dynamic_cast<VcdVar*>(primitive);
+    if (!var)
+    {
+        error = path + " is not a var.";
+        return false;
+    }
+    std::shared_lock<std::shared_mutex> lock(waveform->getValuesMutex());
+    value = var->getRawValueAt(time);
+    return true;
+}
+
+bool WaveformFile::forEachChange(const std::string& path, uint64_t start, uint64_t end,
+    const std::function<void(uint64_t, const std::vector<std::string>&)>& fn)
+{
+    VcdPrimitive* primitive = findPrimitive(path);
+    if (!primitive) return false;
+    std::shared_lock<std::shared_mutex> lock(waveform->getValuesMutex());
+    end = std::min(end, (uint64_t)waveform->getMaxTime());
+    for (uint64_t time = start; time <= end; )
+    {
+        fn(time, primitive->getValueWindow(time, 0, primitive->getSize()));
+        time = primitive->getNextChange(time);
+        if (time == (uint64_t)-1) break;
+    }
+    return true;
+}
+
+bool WaveformFile::sample(const std::vector<std::string>& paths, uint64_t start, uint64_t end, uint64_t period,
+    const std::function<void(uint64_t, const std::vector<std::vector<std::string>>&)>& fn)
+{
+    std::vector<VcdPrimitive*> primitives;
+    for (auto& path : paths)
+    {
+        primitives.push_back(findPrimitive(path));
+        if (!primitives.back()) return false;
+    }
+    if (!period)
+    {
+        error = "The period must be greater than 0.";
+        return false;
+    }
+    std::shared_lock<std::shared_mutex> lock(waveform->getValuesMutex());
+    end = std::min(end, (uint64_t)waveform->getMaxTime());
+    std::vector<std::vector<std::string>> values(primitives.size());
+    for (uint64_t time = start; time <= end; time += period)
+    {
+        for (size_t i = 0; i < primitives.size(); i++)
+        {
+            values[i] = primitives[i]->getValueWindow(time, 0, primitives[i]->getSize());
+        }
+        fn(time, values);
+        if (end - time < period) break;
+    }
+    return true;
+}
@@ -7,12 +7,27 @@
  * Source file for main driver code for Tabuwave
 */
 
+#include <getopt.h>
+#include <glob.h>
 #include <unistd.h>
+#include <algorithm>
+#include <fstream>
 #include <iostream>
 #include <iomanip>
+#include <memory>
+#include <sstream>
 #include <ncurses.h>
+#include <thread>
+#include <vector>
 
+#include "Batch.hpp"
+#include "Exporter.hpp"
+#include "MemoryReport.hpp"
 #include "Parser.hpp"
+#include "RemoteWaveform.hpp"
+#include "Server.hpp"
+#include "ThreadPool.hpp"
+#include "Trace.hpp"
 #include "Vcd.hpp"
 #include "TuiManager.hpp"
 
@@ -24,7 +39,173 @@ void print_help()
 {
     std::cout << "tabuwave [OPTIONS]\n";
     std::cout << "  -h\t\tThis helpful output\n";
-    std::cout << "  -f F\t\tPath to waveform file\n";
+    std::cout << "  -f F\t\tPath to waveform file; repeat, quote a glob (e.g. 'run.*.vcd') or list\n";
+    std::cout << "  \t\tmore files after the options to load a dump split into several files\n";
+    std::cout << "  -d F\t\tPath to a second waveform file to diff against; may also be a glob\n";
+    std::cout << "  -j N\t\tUse N threads for parsing, searches and prefetching; defaults to the cores\n";
+    std::cout << "  \t\tallowed by the CPU affinity mask and cgroup quota (" << ThreadPool::defaultThreads() << " here)\n";
+    std::cout << "  -e CMD\t\tExport the signals of -s without the TUI, e.g. 'out.csv every 10 from 0 to 500';\n";
+    std::cout << "  \t\tCMD is <path> [csv|jsonl|bin] [every <N> | edge <clock>] [from <time>] [to <time>],\n";
+    std::cout << "  \t\twith a path of - for stdout\n";
+    std::cout << "  -s S\t\tComma-separated hierarchical names of the signals to export\n";
+    std::cout << "  --batch Q\tAnswer the queries in file Q (- for stdin) without the TUI, one per line:\n";
+    std::cout << "  \t\t<signals> at <time>[,<time>...] [where <query_str>]\n";
+    std::cout << "  \t\t<signals> from <time> to <time> [every <N>] [where <query_str>]\n";
+    std::cout << "  --serve P\tParse the waveform once and answer queries from clients on Unix socket P\n";
+    std::cout << "  --connect P\tOpen the TUI on the waveform held by the server on Unix socket P instead of -f\n";
+    std::cout << "  --stats F\tWrite statistics of loading the waveform to F as JSON once it is parsed\n";
+    std::cout << "  --memory N\tPrint the N signals and scopes using the most memory without the TUI\n";
+    std::cout << "  --trace F\tWrite a timeline of parsing and of TUI frames to F as Chrome trace JSON at exit\n";
+}
+
+/**
+ * @brief helper function to add the files matching a glob pattern, or the
+ * pattern itself if nothing matches so a missing file is reported
+ * 
+ * @param files (std::vector<std::string>&) files to add to
+ * @param pattern (const char*) path or glob pattern
+ */
+void add_waveform_files(std::vector<std::string>& files, const char* pattern) 
+{
+    glob_t matches;
+    if (glob(pattern, 0, nullptr, &matches) == 0) 
+    {
+        for (size_t i = 0; i < matches.gl_pathc; i++) 
+        {
+            files.emplace_back(matches.gl_pathv[i]);
+        }
+    } 
+    else 
+    {
+        files.emplace_back(pattern);
+    }
+    globfree(&matches);
+}
+
+/**
+ * @brief helper function to write the statistics of loading a waveform as
+ * JSON, if it was parsed and a file was given
+ * 
+ * @param parser (Parser&) parser of the waveform
+ * @param statsFile (const std::string&) file to write, or empty for none
+ */
+void write_stats(Parser& parser, const std::string& statsFile) 
+{
+    if (statsFile.empty() || !parser.isDone()) return;
+    std::ofstream file(statsFile);
+    file << parser.getStats().toJson();
+    if (!file.good()) std::cerr << "Could not write stats file " << statsFile << "\n";
+}
+
+/**
+ * @brief helper function to parse the waveform and export signals to a
+ * file or stdout without the TUI
+ * 
+ * @param parser (Parser&) parser of the waveform
+ * @param command (const std::string&) export command; see Exporter::parseCommand
+ * @param signals (const std::string&) comma-separated hierarchical names
+ * @return int 0 on success
+ */
+int export_signals(Parser& parser, const std::string& command, const std::string& signals) 
+{
+    parser.parse();
+    for (auto& line : parser.getReport()) 
+    {
+        std::cerr << line << "\n";
+    }
+    
+    uint64_t multiplier = 1;
+    char unit[16] = "";
+    sscanf(parser.getTimescale().c_str(), "%llu %15s", (unsigned long long*)&multiplier, unit);
+    Exporter::Options options{Exporter::CSV, 0, parser.getMaxTime(), 0, nullptr, multiplier, unit};
+    std::string path, clockName, error;
+    if (!Exporter::parseCommand(command, options, path, clockName, error)) 
+    {
+        std::cerr << error << "\n";
+        return 1;
+    }
+    if (options.endTime > parser.getMaxTime()) options.endTime = parser.getMaxTime();
+
+    // find the signals and the clock by hierarchical name
+    std::vector<std::pair<std::string, VcdPrimitive*>> columns;
+    std::stringstream ss(signals);
+    std::string name;
+    while (std::getline(ss, name, ',')) 
+    {
+        if (name.empty()) continue;
+        VcdPrimitive* primitive = dynamic_cast<VcdPrimitive*>(parser.getIndex().find(name));
+        if (!primitive) 
+        {
+            std::cerr << "No signal " << name << "\n";
+            return 1;
+        }
+        columns.emplace_back(name, primitive);
+    }
+    if (!clockName.empty()) 
+    {
+        options.clock = dynamic_cast<VcdPrimitive*>(parser.getIndex().find(clockName));
+        if (!options.clock) 
+        {
+            std::cerr << "No signal " << clockName << "\n";
+            return 1;
+        }
+    }
+
+    Exporter exporter;
+    exporter.setColumns(columns);
+    std::ofstream file;
+    if (path != "-") 
+    {
+        file.open(path, std::ios::binary);
+        if (!file.good()) 
+        {
+            std::cerr << "Could not open " << path << "\n";
+            return 1;
+        }
+    }
+    if (!exporter.write((path == "-") ? std::cout : file, options)) 
+    {
+        std::cerr << exporter.getError() << "\n";
+        return 1;
+    }
+    std::cerr << "Exported " << exporter.getRows() << " rows in " << exporter.getSeconds() << " s\n";
+    return 0;
+}
+
+/**
+ * @brief helper function to parse the waveform and answer batch queries
+ * without the TUI
+ * 
+ * @param parser (Parser&) parser of the waveform
+ * @param queryFile (const std::string&) file of queries, or - for stdin
+ * @return int 0 if every query was answered
+ */
+int batch_queries(Parser& parser, const std::string& queryFile) 
+{
+    std::ifstream file;
+    if (queryFile != "-") 
+    {
+        file.open(queryFile);
+        if (!file.good()) 
+        {
+            std::cerr << "Could not open query file " << queryFile << "\n";
+            return 1;
+        }
+    }
+    parser.parse();
+    for (auto& line : parser.getReport()) 
+    {
+        std::cerr << line << "\n";
+    }
+
+    Batch batch(&parser);
+    size_t failed = batch.run((queryFile == "-") ? std::cin : file, std::cout);
+    if (failed) 
+    {
+        std::cerr << failed << " queries could not be answered\n";
+        return 1;
+    }
+    return 0;
 }
 
 /**
@@ -39,13 +220,62 @@ int main(int argc, char **argv)
 {  
     // get command line arguments
     int opt;
-    std::string waveformFile;
-    while (-1 != (opt = getopt(argc, argv, "f:h"))) 
+    std::vector<std::string> waveformFiles;
+    std::vector<std::string> diffFiles;
+    std::string exportCommand;
+    std::string exportSignals;
+    std::string batchFile;
+    std::string servePath;
+    std::string connectPath;
+    std::string statsFile;
+    std::string traceFile;
+    size_t memoryCount = 0;
+    static const struct option longOptions[] = {
+        {"batch", required_argument, nullptr, 'b'},
+        {"serve", required_argument, nullptr, 'S'},
+        {"connect", required_argument, nullptr, 'C'},
+        {"stats", required_argument, nullptr, 'T'},
+        {"memory", required_argument, nullptr, 'M'},
+        {"trace", required_argument, nullptr, 'R'},
+        {"help", no_argument, nullptr, 'h'},
+        {nullptr, 0, nullptr, 0}
+    };
+    while (-1 != (opt = getopt_long(argc, argv, "f:d:e:s:j:h", longOptions, nullptr))) 
     {
         switch (opt) 
         {
             case 'f':
-                waveformFile = optarg;
+                add_waveform_files(waveformFiles, optarg);
+                break;
+            case 'd':
+                add_waveform_files(diffFiles, optarg);
+                break;
+            case 'j':
+                ThreadPool::setThreads(std::max(atoi(optarg), 1));
+                break;
+            case 'e':
+                exportCommand = optarg;
+                break;
+            case 's':
+                exportSignals = optarg;
+                break;
+            case 'b':
+                batchFile = optarg;
+                break;
+            case 'S':
+                servePath = optarg;
+                break;
+            case 'C':
+                connectPath = optarg;
+                break;
+            case 'T':
+                statsFile = optarg;
+                break;
+            case 'M':
+                memoryCount = std::max(atoi(optarg), 1);
+                break;
+            case 'R':
+                traceFile = optarg;
                 break;
             case 'h':
                 /* Fall through */
@@ -54,30 +284,149 @@ int main(int argc, char **argv)
                 return 0;
         }
     }
+    // remaining arguments are more files of the waveform, e.g. from a 
+    // glob expanded by the shell
+    for (int i = optind; i < argc; i++) 
+    {
+        add_waveform_files(waveformFiles, argv[i]);
+    }
 
-    if (waveformFile.empty()) 
+    if (!connectPath.empty()) 
+    {
+        if (!waveformFiles.empty() || !diffFiles.empty() || !statsFile.empty()) 
+        {
+            std::cerr << "--connect takes the waveform from the server; -f, -d and --stats are not used with it\n";
+            return 1;
+        }
+    }
+    else if (waveformFiles.empty()) 
     {
         std::cerr << "No waveform file provided\n";
         print_help();
         return 1;
     }
     
-    TuiManager tui;
+    for (auto& file : waveformFiles) 
+    {
+        if (!std::ifstream(file).good()) 
+        {
+            std::cerr << "Could not open waveform file " << file << "\n";
+            return 1;
+        }
+    }
+    for (auto& file : diffFiles) 
+    {
+        if (!std::ifstream(file).good()) 
+        {
+            std::cerr << "Could not open waveform file " << file << "\n";
+            return 1;
+        }
+    }
+    if (!traceFile.empty()) Trace::start(traceFile);
 
-    Parser parser(waveformFile);
-    parser.parse();
+    if (!exportCommand.empty()) 
+    {
+        Parser parser(waveformFiles);
+        int status = export_signals(parser, exportCommand, exportSignals);
+        write_stats(parser, statsFile);
+        return status;
+    }
+    if (!batchFile.empty()) 
+    {
+        Parser parser(waveformFiles);
+        int status = batch_queries(parser, batchFile);
+        write_stats(parser, statsFile);
+        return status;
+    }
+    if (memoryCount) 
+    {
+        Parser parser(waveformFiles);
+        parser.parse();
+        for (auto& line : MemoryReport(parser.getIndex(), parser.getValueTable(), memoryCount).format()) 
+        {
+            std::cout << line << "\n";
+        }
+        write_stats(parser, statsFile);
+        return 0;
+    }
+    if (!servePath.empty()) 
+    {
+        // answer clients while the values are still being read; the socket
+        // is created first so the parse never outlives a failed start
+        Parser parser(waveformFiles);
+        Server server(&parser, ThreadPool::get().getThreads());
+        std::string error;
+        if (!server.listen(servePath, error)) 
+        {
+            std::cerr << error << "\n";
+            return 1;
+        }
+        std::thread parseThread(
+            [&parser, &statsFile]() 
+            {
+                parser.parse();
+                write_stats(parser, statsFile);
+            }
+        );
+        parseThread.detach();
+        std::cerr << "Serving on " << servePath << "\n";
+        server.run();
+        return 0;
+    }
+
+    std::unique_ptr<Waveform> waveform;
+    if (!connectPath.empty()) 
+    {
+        RemoteWaveform* remote = new RemoteWaveform();
+        waveform.reset(remote);
+        std::string error;
+        if (!remote->connect(connectPath, error)) 
+        {
+            std::cerr << error << "\n";
+            return 1;
+        }
+    }
+    else 
+    {
+        // parse in the background so the menu is usable as soon as the
+        // definitions are parsed, while the values are still being read
+        Parser* parser = new Parser(waveformFiles);
+        waveform.reset(parser);
+        std::thread parseThread(
+            [parser, &statsFile]() 
+            {
+                parser->parse();
+                write_stats(*parser, statsFile);
+            }
+        );
+        parseThread.detach();
+    }
 
-    tui.setMaxTime(parser.getMaxTime());
-    tui.setTimescale(parser.getTimescale());
-    tui.displayBottomLine(DISPLAY_INFO, "ENTER to continue\n\r");
+    TuiManager tui;
+    tui.setParser(waveform.get());
 
-    refresh();
-    while(getch() != '\n');
+    // parse the waveform to diff against at the same time
+    std::unique_ptr<Parser> diffParser;
+    if (!diffFiles.empty()) 
+    {
+        diffParser.reset(new Parser(diffFiles));
+        Parser* diff = diffParser.get();
+        std::thread diffThread(
+            [diff]() 
+            {
+                diff->parse();
+            }
+        );
+        diffThread.detach();
+        tui.setDiffParser(diff);
+    }
+    tui.displayStartup();
+    tui.setTimescale(waveform->getTimescale());
     erase(); 
 
     while (1) 
     {
-        tui.displayMenuMode(parser.getTop());
+        tui.displayMenuMode(waveform->getTop());
         erase();
         echo();
         tui.displayTableMode();